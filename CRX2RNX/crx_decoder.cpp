@@ -0,0 +1,1444 @@
+/****************************************************************************/
+/*     crx_decoder : recovery of the RINEX file from Compact RINEX file     */
+/*                                                                          */
+/*     The main loop, getdiff(), data(), putfield() and print_clock() of    */
+/*     CRX2RNX. Functions return                                            */
+/*          0 : normal end                                                  */
+/*          1 : something strange is found (skip to the next epoch)         */
+/*         -1 : error (the error number is kept in err_no)                  */
+/*                                                                          */
+/*     Copyright (c) 2007 Geospatial Information Authority of Japan         */
+/****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "crx_decoder.h"
+#include "../common/int_text.h"
+#include "../common/str_diff.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GETDIFF_SSE2
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+/*** define macros ***/
+#define CHOP_BLANK(q,p) p = strchr(q,'\0');if(p>q){while(*--p == ' ' && p>q);p++;}*p = '\0'
+
+static const size_t C1 = sizeof("");               /* size of one character */
+static const size_t C2 = sizeof(" ");              /* size of 2-character string */
+static const size_t C3 = sizeof("  ");             /* size of 3-character string */
+
+/*---------------------------------------------------------------------*/
+crx_decoder::crx_decoder() {
+    skip = 0;
+    output_overflow = 0;
+    err_no = 0;
+    normal_end = 0;
+    use_mmap = 1;
+    block_size = DEFAULT_BLOCK_SIZE;
+    flush_epoch = 0;
+    pipeline = 0;
+    use_window = 0;
+    index = NULL;
+    nthread = 0;
+    stats = NULL;
+    defer_messages = 0;
+    muted = 0;
+    bank = 0;
+    dy1 = dy0 = NULL;
+    st1 = st0 = NULL;
+    flag1 = flag = dflag = NULL;
+    out_buff = p_buff = NULL;
+    out_size = 0;
+}
+/*---------------------------------------------------------------------*/
+crx_decoder::~crx_decoder() {
+    free(out_buff);
+}
+/*---------------------------------------------------------------------*/
+int crx_decoder::convert(FILE* in, FILE* out) {
+    unsigned long long out_bytes = 0;
+    int rc;
+
+    init_state();
+    reader.open(in, use_mmap, pipeline);
+    writer.open(out, block_size, pipeline);
+    if (stats != NULL) stats->start();
+    if (nthread > 1 && reader.mapped() && !skip && !output_overflow && !use_window && !flush_epoch) {
+        rc = recover_parallel();
+    }
+    else {
+        rc = recover();
+    }
+    if (stats != NULL) {
+        stats->enter(PHASE_OUTPUT);
+        out_bytes = writer.tell();
+    }
+    writer.close();
+    if (stats != NULL) stats->stop(out_bytes);
+    reader.close();
+    return rc;
+}
+/*---------------------------------------------------------------------*/
+void crx_decoder::init_state(void) {
+    int i;
+
+    nl_count = 0;
+    ntype = 0;
+    ntype_max = 0;
+    clk_order = 0;
+    clk_arc_order = 0;
+    exit_status = EXIT_SUCCESS;
+    err_no = 0;
+    normal_end = 0;
+    memset(&clk0, 0, sizeof(clk0));
+    memset(&clk1, 0, sizeof(clk1));
+    line[0] = '\0';
+    nsat1 = 0;
+    muted = use_window;
+    if (use_window) {
+        key_start = time_key(&t_start);
+        key_end = time_key(&t_end);
+    }
+    bound = NULL;
+    nbound = next_bound = 0;
+    stopped = 0;
+    messages.clear();
+    type_sys = -1;
+    for (i = 0; i <= UCHAR_MAX; i++) {
+        type_out[i].clear();
+        type_cols[i].clear();
+    }
+}
+/*---------------------------------------------------------------------*/
+int crx_decoder::recover(void) {
+    /**** read the header and recover each epoch ****/
+    int i;
+
+    for (i = 0; i < UCHAR_MAX; i++)ntype_gnss[i] = -1;  /** -1 unless GNSS type is defined **/
+    if (header() != 0) return EXIT_FAILURE;
+    if (use_window) seek_window();
+    return epochs();
+}
+/*---------------------------------------------------------------------*/
+int crx_decoder::epochs(void) {
+    /**** main loop: recover each epoch ****/
+    char* p, * q;
+    const char* use;
+    int sattbl[MAXSAT], i, * i0, n, nout, rc;
+    size_t offset;
+    unsigned long long clk_bytes = 0;
+    char* p_event, * p_nsat, * p_satlst, shift_clk;
+    char sat_lst_out[MAXSAT * 3 + 1], epoch_out[72];  /* epoch line with the selected satellites */
+    /* sattbl[i]: order (at the previous epoch) of i-th satellite */
+    /* (at the current epoch). -1 is set for the new satellites   */
+
+    if (reserve_epoch(NSAT_INIT) != 0) { error(21, ""); return EXIT_FAILURE; }
+    if (rinex_version == 2) {
+        ep_top_from = '&';
+        ep_top_to = ' ';
+        p_event = &dline[28];  /** pointer to event flug **/
+        p_nsat = &line[29];  /** pointer to n_sat **/
+        p_satlst = &line[32];  /** pointer to address to add satellite list **/
+        shift_clk = 1;
+        offset = 3;
+    }
+    else {
+        ep_top_from = '>';
+        ep_top_to = '>';
+        p_event = &dline[31];
+        p_nsat = &line[32];
+        p_satlst = &line[41];
+        shift_clk = 4;
+        offset = 6;
+    }
+
+    for (;;) {
+        if (nbound > 0 && at_bound()) {     /*** the next segment starts here ***/
+            stopped = 1;
+            return exit_status;
+        }
+        if (stats != NULL) stats->enter(PHASE_READ);
+        if (get_line(dline) == NULL) break; /*** exit program successfully ***/
+        nl_count++;
+    SKIP:
+        if (crinex_version == 3) { /*** skip escape lines of CRINEX version 3 ***/
+            while (dline[0] == '&') {
+                nl_count++;
+                if (get_line(dline) == NULL) { normal_end = 1; return exit_status; }
+            }
+        }
+        if (stats != NULL) stats->enter(PHASE_PARSE);
+        if (dline[0] == ep_top_from) {
+            dline[0] = ep_top_to;
+            if (*p_event != '0' && *p_event != '1') {
+                if (stats != NULL) stats->enter(PHASE_OTHER);
+                if ((rc = put_event_data(dline, p_event)) < 0) return EXIT_FAILURE;
+                if (rc == 2) return exit_status;            /** EOF after the event data **/
+                if (rc != 0 && skip_to_next(dline) != 0) return exit_status;
+                goto SKIP;
+            }
+            line[0] = '\0';          /**** initialize arc for epoch data ***/
+            nsat1 = 0;               /**** initialize the all satellite arcs ****/
+        }
+        else if (dline[0] == '\032') {
+            normal_end = 1;    /** DOS EOF **/
+            return exit_status;
+        }
+        /****  read, repair the line  ****/
+        str_repair(line, dline);
+        p = &line[offset];  /** pointer to the space between year and month **/
+        if (line[0] != ep_top_to || strlen(line) < (26 + offset) || *(p + 23) != ' '
+            || *(p + 24) != ' ' || !isdigit(*(p + 25))) {
+            if (skip_to_next(dline) != 0) return exit_status;
+            goto SKIP;
+        }
+        CHOP_BLANK(line, p);
+        if (use_window) {
+            if ((rc = window_state(line)) > 0) return exit_status;  /** after the time window **/
+            muted = (rc < 0);
+        }
+
+        nsat = atoi(p_nsat);
+        if (nsat > MAXSAT) { error(6, p_nsat); return EXIT_FAILURE; }
+        if (reserve_epoch(nsat) != 0) { error(21, line); return EXIT_FAILURE; }
+
+        if (set_sat_table(p_satlst, sat_lst_old, nsat1, sattbl) != 0) return EXIT_FAILURE; /****  set satellite table  ****/
+        if (stats != NULL) stats->enter(PHASE_READ);
+        rc = read_chk_line(dline);
+        if (stats != NULL) stats->enter(PHASE_PARSE);
+        if (rc != 0) {
+            if (rc < 0) return EXIT_FAILURE;
+            if (skip_to_next(dline) != 0) return exit_status;
+            goto SKIP;
+        }
+        if (read_clock(dline, clk1.y) != 0) return EXIT_FAILURE;
+        for (i = 0, i0 = sattbl; i < nsat; i++, i0++) {
+            ntype = ntype_record[i];
+            use = type_filter.empty() ? NULL : type_out[(rinex_version == 2) ? 0 : (unsigned char)p_satlst[i * 3]].data();
+            if ((rc = getdiff(st1[i], (*i0 < 0) ? NULL : st0[*i0], dy1[i * NPLANE], *i0, dflag[i], use)) != 0) {
+                if (rc < 0) return EXIT_FAILURE;
+                if (skip_to_next(dline) != 0) return exit_status;
+                goto SKIP;
+            }
+        }
+
+        /*************************************/
+        /**** print the recovered line(s) ****/
+        /*************************************/
+        if (stats != NULL) stats->enter(PHASE_ARC);
+        if (dline[0] != '\0') process_clock();
+        if (stats != NULL) {
+            stats->enter(PHASE_FORMAT);
+            clk_bytes = stats->bytes[BYTES_CLOCK];
+        }
+        p_buff = out_buff;
+        nout = select_sats(p_satlst);   /** none before the time window **/
+
+        if (muted) {
+            /**** nothing is formatted: only the arcs are updated in data() ****/
+        }
+        else if (rinex_version == 2) {
+            if (nout != nsat) {         /** the list of the selected satellites **/
+                for (i = 0, p = p_satlst, q = sat_lst_out; i < nsat; i++, p += 3) {
+                    if (sat_out[i]) { memcpy(q, p, C3); q += 3; }
+                }
+                *q = '\0';
+                sprintf(epoch_out, "%-29.29s%3d%.36s", line, nout, sat_lst_out);
+                q = epoch_out;
+            }
+            else {
+                q = line;
+            }
+            if (clk_order >= 0) {
+                p_buff += sprintf(p_buff, "%-68.68s", q);
+                if (print_clock(clk1.y[clk_order], shift_clk) != 0) return EXIT_FAILURE;
+            }
+            else {
+                p_buff += sprintf(p_buff, "%.68s\n", q);
+            }
+            p = (q == line) ? &line[68] : &sat_lst_out[36];
+            for (n = nout - 12; n > 0; n -= 12, p += 36) p_buff += sprintf(p_buff, "%32.s%.36s\n", " ", p);
+        }
+        else {
+            if (clk_order >= 0) {
+                p_buff += sprintf(p_buff, "%.41s", line);
+                if (print_clock(clk1.y[clk_order], shift_clk) != 0) return EXIT_FAILURE;
+            }
+            else {
+                sprintf(p_buff, "%.41s", line);
+                CHOP_BLANK(p_buff, p); *p++ = '\n'; p_buff = p;
+            }
+            if (nout != nsat && strlen(line) >= 35) {   /** number of the selected satellites **/
+                sprintf(epoch_out, "%3d", nout);
+                memcpy(&out_buff[32], epoch_out, C3);
+            }
+        }
+        if (stats != NULL) {    /** the clock offset was added by print_clock() **/
+            stats->bytes[BYTES_EPOCH] += (size_t)(p_buff - out_buff) - (stats->bytes[BYTES_CLOCK] - clk_bytes);
+        }
+
+        if (data(p_satlst, sattbl, dflag) != 0) return EXIT_FAILURE;
+
+        put_epoch();
+        if (stats != NULL) {
+            stats->epochs++;
+            stats->sats += nsat;
+        }
+        /****************************/
+        /**** save current epoch ****/
+        /****************************/
+        nsat1 = nsat;
+        clk0 = clk1;
+        strncpy(sat_lst_old, p_satlst, nsat * C3);
+        swap_epoch();
+    }
+    normal_end = 1;
+    return exit_status;
+}
+/*---------------------------------------------------------------------*/
+void crx_decoder::swap_epoch(void) {
+    /**** the current epoch becomes the previous one ****/
+    bank ^= 1;
+    dy1 = dy_bank[bank].row; dy0 = dy_bank[bank ^ 1].row;
+    st1 = st_bank[bank].row; st0 = st_bank[bank ^ 1].row;
+    flag = flag_bank[bank].row; flag1 = flag_bank[bank ^ 1].row;
+}
+/*---------------------------------------------------------------------*/
+int  crx_decoder::reserve_epoch(int n) {
+    /**** tables for n satellites and ntype_max data types (the values ****/
+    /**** NPLANE rows per satellite). They are enlarged (keeping the    ****/
+    /**** contents) only if too small.                                 ****/
+    size_t size;
+    char* p;
+    int k;
+
+    if (out_buff != NULL && n <= st_bank[0].rows() && ntype_max <= st_bank[0].cols()) return 0;
+    for (k = 0; k < 2; k++) {
+        if (st_bank[k].reserve(n, ntype_max) != 0) return -1;
+        if (dy_bank[k].reserve(st_bank[k].rows() * NPLANE, ntype_max) != 0) return -1;
+        if (flag_bank[k].reserve(n, ntype_max * 2 + 1) != 0) return -1;
+    }
+    if (dflag_table.reserve(n, ntype_max * 2 + 1) != 0) return -1;
+    dy1 = dy_bank[bank].row; dy0 = dy_bank[bank ^ 1].row;
+    st1 = st_bank[bank].row; st0 = st_bank[bank ^ 1].row;
+    flag = flag_bank[bank].row; flag1 = flag_bank[bank ^ 1].row;
+    dflag = dflag_table.row;
+
+    /**** epoch lines and (up to 25 characters per field) the data ****/
+    size = 2 * MAXCLM + (size_t)st_bank[0].rows() * ((size_t)st_bank[0].cols() * 25 + 16);
+    if (size > out_size) {
+        if ((p = (char*)realloc(out_buff, size)) == NULL) return -1;
+        out_buff = p;
+        out_size = size;
+    }
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+int  crx_decoder::header(void) {
+    char line[MAXCLM], * p;
+    int rc;
+    std::string text;
+
+    if ((rc = read_chk_line(line)) != 0) return (rc < 0) ? rc : error(5, "1.0-2.0");
+    crinex_version = atoi(line);
+    if ((strncmp(&line[0], "1.0", C3) != 0 && strncmp(&line[0], "3.0", C3) != 0) ||
+        strncmp(&line[60], "CRINEX VERS   / TYPE", C1 * 19) != 0) return error(5, "1.0-2.0");
+    if ((rc = read_chk_line(line)) != 0) return (rc < 0) ? rc : error(8, line);
+
+    if ((rc = read_chk_line(line)) != 0) return (rc < 0) ? rc : error(8, line);
+    CHOP_BLANK(line, p);
+    writer.print("%s\n", line);
+    if (strncmp(&line[60], "RINEX VERSION / TYPE", C1 * 20) != 0 ||
+        (line[5] != '2' && line[5] != '3' && line[5] != '4')) return error(15, "2.x, 3.x  or 4.x");
+    rinex_version = atoi(line);
+
+    do {
+        if (read_chk_line(line) < 0) return -1;
+        CHOP_BLANK(line, p);
+        text.clear();
+        if ((sat_filter.empty() && type_filter.empty()) || (strncmp(&line[60], "# OF SATELLITES", C1 * 15) != 0
+            && strncmp(&line[60], "PRN / # OF OBS", C1 * 14) != 0)) {   /** not valid for the selected satellites or types **/
+            put_header_line(line, &text);
+        }
+        writer.write(text.data(), text.size());
+        if (strncmp(&line[60], "# / TYPES OF OBSERV", C1 * 19) == 0 && line[5] != ' ') {
+            ntype = atoi(line);                                        /** for RINEX2 **/
+            if (ntype > MAXTYPE) return error(16, line);
+            if (ntype > ntype_max) ntype_max = ntype;
+        }
+        else if (strncmp(&line[60], "SYS / # / OBS TYPES", C1 * 19) == 0) { /** for RINEX3  **/
+            if (line[0] != ' ') ntype_gnss[(unsigned int)line[0]] = atoi(&line[3]);
+            if (ntype_gnss[(unsigned int)line[0]] > MAXTYPE) return error(16, line);
+            if (ntype_gnss[(unsigned int)line[0]] > ntype_max) ntype_max = ntype_gnss[(unsigned int)line[0]];
+        }
+    } while (strncmp(&line[60], "END OF HEADER", C1 * 13) != 0);
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+void crx_decoder::put_epoch(void) {
+    /**** pass the recovered epoch to the output block.         ****/
+    /**** The text is cut at '\0' if any, as fprintf("%s") did. ****/
+    const char* p;
+    size_t len = (size_t)(p_buff - out_buff);
+
+    if (stats != NULL) stats->enter(PHASE_OUTPUT);
+    if (muted) return;
+    if ((p = (const char*)memchr(out_buff, '\0', len)) != NULL) len = (size_t)(p - out_buff);
+    writer.write(out_buff, len);
+    if (flush_epoch) writer.flush();
+}
+/*---------------------------------------------------------------------*/
+int  crx_decoder::read_clock(char* dline, fixed_t* y) {
+    char* p, * s, * p1;
+    long yu, yl;
+
+    p = dline;
+
+    if (*p == '\0') {
+        clk_order = -1;
+    }
+    else {
+        if (*(p + 1) == '&') {        /**** for the case of arc initialization ****/
+            sscanf(p, "%d&", &clk_arc_order);
+            if (clk_arc_order > MAX_DIFF_ORDER) return error(7, dline);
+            clk_order = -1;
+            p += 2;
+        }
+        p1 = p; if (*p == '-') p1++;
+        s = strchr(p1, '\0');
+        if ((s - p1) < 9) {                /** s-p1 == strlen(p1) ***/
+            yu = 0;
+            yl = atol(p);
+        }
+        else {
+            s -= 8;
+            yl = atol(s);
+            *s = '\0';
+            yu = atol(p);
+            if (yu < 0) yl = -yl;
+        }
+        if (yu >= FIXED_LIMIT / 100000000 || yu <= -FIXED_LIMIT / 100000000) {
+            *y = (yu < 0) ? -FIXED_LIMIT : FIXED_LIMIT;     /** out of range **/
+        }
+        else {
+            *y = (fixed_t)yu * 100000000 + yl;
+        }
+    }
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+void crx_decoder::process_clock(void) {
+    int i, j;
+    /****************************************/
+    /**** recover the clock offset value ****/
+    /****************************************/
+    if (clk_order < clk_arc_order) {
+        clk_order++;
+        for (i = 0, j = 1; i < clk_order; i++, j++) clk1.y[j] = fixed_add(clk1.y[i], clk0.y[i]);
+    }
+    else {
+        for (i = 0, j = 1; i < clk_order; i++, j++) clk1.y[j] = fixed_add(clk1.y[i], clk0.y[j]);
+    }
+}
+/*---------------------------------------------------------------------*/
+int  crx_decoder::put_event_data(char* dline, char* p_event) {
+    /***********************************************************************/
+    /*  - Put event data for one event.                                    */
+    /*  - This function is called when the event flag > 1.                 */
+    /*  - return value 2 : the file ended after the event data             */
+    /*                     (or the time window is passed, or the next       */
+    /*                     segment starts here (-J))                        */
+    /***********************************************************************/
+    int i, n, nl, rc;
+    char* p, count[8];
+    size_t pos = (size_t)(p_event - dline) + 1;   /** number of the records in the event line **/
+    std::string event, text;
+    do {
+        dline[0] = ep_top_to;
+        CHOP_BLANK(dline, p);
+        if (use_window) {
+            if ((rc = window_state(dline)) > 0) return 2;   /** after the time window **/
+            muted = (rc < 0);
+        }
+        event = dline;
+        text.clear();
+        n = nl = 0;
+        if (strlen(dline) > 29) {
+            n = atoi((p_event + 1));
+            for (i = 0; i < n; i++) {
+                if (read_chk_line(dline) < 0) return -1;
+                CHOP_BLANK(dline, p);
+                nl += put_header_line(dline, &text);
+                if (strncmp(&dline[60], "# / TYPES OF OBSERV", C1 * 19) == 0 && dline[5] != ' ') {
+                    nbound = 0;     /** the following segments assumed the types in the header **/
+                    ntype = atoi(dline);                                        /** for RINEX2 **/
+                    if (ntype > MAXTYPE) return error(16, dline);
+                    if (ntype > ntype_max) ntype_max = ntype;
+                }
+                else if (strncmp(&dline[60], "SYS / # / OBS TYPES", C1 * 19) == 0) { /** for RINEX3 **/
+                    nbound = 0;
+                    if (dline[0] != ' ') ntype_gnss[(unsigned int)dline[0]] = atoi(&dline[3]);
+                    if (ntype_gnss[(unsigned int)dline[0]] > MAXTYPE) return error(16, dline);
+                    if (ntype_gnss[(unsigned int)dline[0]] > ntype_max) ntype_max = ntype_gnss[(unsigned int)dline[0]];
+                }
+            }
+            nl += put_types(&text);
+        }
+        if (nl != n && event.size() >= pos + 3) {   /** lists of the types rewritten (-O) **/
+            sprintf(count, "%3d", nl);
+            event.replace(pos, 3, count);
+        }
+        if (!muted) {
+            writer.print("%s\n", event.c_str());
+            writer.write(text.data(), text.size());
+        }
+
+        do {
+            if (nbound > 0 && at_bound()) {         /*** the next segment starts here ***/
+                stopped = 1;
+                return 2;
+            }
+            nl_count++;
+            if (get_line(dline) == NULL) return 2;  /*** eof: exit program successfully ***/
+        } while (crinex_version >= 3 && dline[0] == '&');
+
+        if (dline[0] != ep_top_from || strlen(dline) < 29 || !isdigit(*p_event)) {
+            if (!skip) return error(9, dline);
+            warn("WARNING :  The epoch should be initialized, but not.\n");
+            return 1;
+        }
+    } while (*p_event != '0' && *p_event != '1');
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+int  crx_decoder::skip_to_next(char* dline) {
+    /**** return value 1 : next epoch is not found before EOF ****/
+    char* p;
+    exit_status = EXIT_WARNING;
+    if (stats != NULL) stats->skipped++;
+    warn("    line %ld : skip until an initialized epoch is found.", nl_count);
+    if (rinex_version == 2) {
+        p = dline + 3;    /** pointer to the space between year and month **/
+    }
+    else {
+        p = dline + 6;
+    }
+
+    do {
+        nl_count++;
+        if (get_line(dline) == NULL) {
+            warn("  .....next epoch not found before EOF.\n");
+            if (muted) return 1;
+            if (rinex_version == 2) {
+                writer.print("%29d%3d\n%-60sCOMMENT\n", 4, 1, "  *** Some epochs are skipped by CRX2RNX ***");
+            }
+            else {
+                writer.print(">%31d%3d\n%-60sCOMMENT\n", 4, 1, "  *** Some epochs are skipped by CRX2RNX ***");
+            }
+            return 1;
+        }
+    } while (dline[0] != ep_top_from || strlen(dline) < 29 || *p != ' '
+        || *(p + 3) != ' ' || *(p + 6) != ' ' || *(p + 9) != ' '
+        || *(p + 12) != ' ' || *(p + 23) != ' ' || *(p + 24) != ' '
+        || !isdigit(*(p + 25)));
+
+    warn("  .....next epoch found at line %ld.\n", nl_count);
+    if (muted) return 0;
+    if (rinex_version == 2) {
+        writer.print("%29d%3d\n%-60sCOMMENT\n", 4, 1, "  *** Some epochs are skipped by CRX2RNX ***");
+    }
+    else {
+        writer.print(">%31d%3d\n%-60sCOMMENT\n", 4, 1, "  *** Some epochs are skipped by CRX2RNX ***");
+    }
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+void crx_decoder::seek_window(void) {
+    /**** start from the last initialized epoch in the index before   ****/
+    /**** the time window, instead of the epoch just after the header ****/
+    const index_entry* e;
+
+    if (index == NULL || (e = index->find(&t_start)) == NULL) return;
+    if (reader.seek(e->offset) == 0) nl_count = e->line - 1;
+}
+/*---------------------------------------------------------------------*/
+int  crx_decoder::window_state(const char* epoch_line) const {
+    /**** -1 : before the time window, 0 : in it, 1 : after it.  ****/
+    /**** For an epoch line without time (event records), the    ****/
+    /**** state of the previous epoch.                          ****/
+    epoch_time t;
+    double key;
+
+    if (read_epoch_time(epoch_line, &t) != 0) return muted ? -1 : 0;
+    key = time_key(&t);
+    if (key > key_end) return 1;
+    return (key < key_start) ? -1 : 0;
+}
+/*---------------------------------------------------------------------*/
+int  crx_decoder::set_sat_table(char* p_new, char* p_old, int nsat1, int* sattbl) {
+    /***********************************************************************/
+    /*  - Read number of satellites (nsat)                                 */
+    /*  - Compare the satellite list at the epoch (*p_new) and that at the */
+    /*    previous epoch(*p_old), and make index (*sattbl) for the         */
+    /*    corresponding order of the satellites.                           */
+    /*    *sattbl is set to -1 for new satellites.                         */
+    /***********************************************************************/
+    int i, j;
+    char* ps;
+
+    /*** set # of data types for each satellite ***/
+    if (rinex_version == 2) {             /** for RINEX2 **/
+        for (i = 0; i < nsat; i++) { ntype_record[i] = ntype; }
+    }
+    else {                                /** for RINEX3 **/
+        for (i = 0, ps = p_new; i < nsat; i++, ps += 3) {
+            ntype_record[i] = ntype_gnss[(unsigned int)*ps];  /*** # of data type for the GNSS system ***/
+            if (ntype_record[i] < 0) return error(20, p_new);
+        }
+    }
+    if (sat_old.set(p_old, nsat1) == 0) {
+        /**** the previous satellites are indexed: no comparison of the lists ****/
+        for (i = 0; i < nsat; i++, p_new += 3) *sattbl++ = sat_old.find(p_new);
+        return 0;
+    }
+    for (i = 0; i < nsat; i++, p_new += 3) {
+        *sattbl = -1;
+        for (j = 0, ps = p_old; j < nsat1; j++, ps += 3) {
+            if (strncmp(p_new, ps, C3) == 0) {
+                *sattbl = j;
+                break;
+            }
+        }
+        sattbl++;
+    }
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+int  crx_decoder::set_filter(const char* systems, const char* prns) {
+    /**** systems : GNSS systems to be output (e.g. "GE"), NULL: all      ****/
+    /**** prns    : satellites to be output (e.g. "G01,E05"), NULL: all   ****/
+    /**** returns 0, or -1 if the list of the satellites is not valid     ****/
+    std::vector<char> prn_list;
+    const char* p;
+    int c, n, k;
+
+    sat_filter.clear();
+    if (systems == NULL && prns == NULL) return 0;
+    if (prns != NULL) {
+        prn_list.assign((UCHAR_MAX + 1) * 100, 0);
+        for (p = prns; *p != '\0'; p += (*p == ',') ? 1 : 0) {
+            if (!isupper((unsigned char)*p) || sscanf(p + 1, "%2d%n", &n, &k) != 1 || n < 0 || n > 99) return -1;
+            prn_list[(unsigned char)*p * 100 + n] = 1;
+            p += 1 + k;
+            if (*p != ',' && *p != '\0') return -1;
+        }
+    }
+    sat_filter.assign((UCHAR_MAX + 1) * 100, 0);
+    for (c = 0; c <= UCHAR_MAX; c++) {
+        if (systems != NULL && (c == 0 || strchr(systems, c) == NULL)) continue;
+        for (n = 0; n < 100; n++) sat_filter[c * 100 + n] = (prns == NULL) ? 1 : prn_list[c * 100 + n];
+    }
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+int  crx_decoder::select_sats(const char* p_satlst) {
+    /**** set sat_out[] for the satellites to be output at the epoch ****/
+    /**** and return the number of them. The satellites of a system  ****/
+    /**** without any of the selected types are not output.          ****/
+    const char* p;
+    int i, n, c, prn;
+
+    if (muted) {
+        memset(sat_out, 0, (size_t)nsat);
+        return 0;
+    }
+    if (sat_filter.empty() && type_filter.empty()) {
+        memset(sat_out, 1, (size_t)nsat);
+        return nsat;
+    }
+    for (i = n = 0, p = p_satlst; i < nsat; i++, p += 3) {
+        if (sat_filter.empty()) {
+            sat_out[i] = 1;
+        }
+        else {
+            c = (*p == ' ') ? 'G' : (unsigned char)*p;      /** blank : GPS (RINEX2) **/
+            prn = (isdigit((unsigned char)p[1]) ? (p[1] - '0') * 10 : 0) + (isdigit((unsigned char)p[2]) ? p[2] - '0' : 0);
+            sat_out[i] = sat_filter[c * 100 + prn];
+        }
+        if (!type_filter.empty() && type_cols[(rinex_version == 2) ? 0 : (unsigned char)*p].empty()) sat_out[i] = 0;
+        n += sat_out[i];
+    }
+    return n;
+}
+/*---------------------------------------------------------------------*/
+int  crx_decoder::set_types(const char* types) {
+    /**** types : observation types to be output, e.g. "C1C,L1C,C2W,L2W" ****/
+    /****         (RINEX 3/4) or "C1,L1,P2,L2" (RINEX 2), NULL: all       ****/
+    /**** returns 0, or -1 if the list of the types is not valid          ****/
+    const char* p, * q;
+
+    type_filter.clear();
+    if (types == NULL) return 0;
+    for (p = types;; p = q + 1) {
+        for (q = p; isalnum((unsigned char)*q); q++) {}
+        if (q - p < 2 || q - p > 3 || (*q != ',' && *q != '\0')) {
+            type_filter.clear();
+            return -1;
+        }
+        type_filter.push_back(std::string(p, (size_t)(q - p)));
+        if (*q == '\0') break;
+    }
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+int  crx_decoder::put_header_line(const char* line, std::string* text) {
+    /**** append a line of the header (or of the event records) to text, ****/
+    /**** and return the number of the lines appended. With type_filter,  ****/
+    /**** a list of the observation types is kept until it is complete    ****/
+    /**** and then appended by put_types().                               ****/
+    int len, pos, width, step, nline = 0;
+
+    if (!type_filter.empty()) {
+        if (strncmp(&line[60], "# / TYPES OF OBSERV", C1 * 19) == 0) {        /** RINEX2 : 9(4X,A2) **/
+            if (line[5] != ' ') {
+                nline = put_types(text);
+                type_sys = 0;
+                type_count = atoi(line);
+                type_codes.clear();
+            }
+            pos = 10; width = 2; step = 6;
+        }
+        else if (strncmp(&line[60], "SYS / # / OBS TYPES", C1 * 19) == 0) {   /** RINEX3 : 13(1X,A3) **/
+            if (line[0] != ' ') {
+                nline = put_types(text);
+                type_sys = (unsigned char)line[0];
+                type_count = atoi(&line[3]);
+                type_codes.clear();
+            }
+            pos = 7; width = 3; step = 4;
+        }
+        else {
+            pos = width = step = 0;
+            nline = put_types(text);        /** the list ended **/
+        }
+        if (type_sys >= 0) {
+            len = (int)strlen(line);
+            if (len > 60) len = 60;
+            for (; pos + width <= len && (int)type_codes.size() < type_count; pos += step) {
+                type_codes.push_back(std::string(&line[pos], (size_t)width));
+            }
+            if ((int)type_codes.size() >= type_count) nline += put_types(text);
+            return nline;
+        }
+    }
+    text->append(line);
+    text->push_back('\n');
+    return nline + 1;
+}
+/*---------------------------------------------------------------------*/
+int  crx_decoder::put_types(std::string* text) {
+    /**** append the list of the types being read with only the selected ****/
+    /**** types, set type_out[] and type_cols[] of the system, and return ****/
+    /**** the number of the lines appended. The list of a RINEX3 system   ****/
+    /**** without any of the selected types is removed.                  ****/
+    char buff[MAXCLM], * p;
+    int j, k, n, per, nline = 0;
+
+    if (type_sys < 0) return 0;
+    std::vector<char>& out = type_out[type_sys];
+    std::vector<int>& cols = type_cols[type_sys];
+    out.assign(MAXTYPE, 0);
+    cols.clear();
+    for (j = 0; j < type_count && j < MAXTYPE && j < (int)type_codes.size(); j++) {
+        for (k = 0; k < (int)type_filter.size(); k++) {
+            if (type_codes[j] == type_filter[k]) {
+                out[j] = 1;
+                cols.push_back(j);
+                break;
+            }
+        }
+    }
+    n = (int)cols.size();
+    per = (type_sys == 0) ? 9 : 13;
+    for (j = 0; j < n || (j == 0 && type_sys == 0); j += per) {
+        p = buff;
+        if (j > 0) p += sprintf(p, "%6s", "");
+        else if (type_sys == 0) p += sprintf(p, "%6d", n);
+        else p += sprintf(p, "%c  %3d", type_sys, n);
+        for (k = j; k < n && k < j + per; k++) {
+            p += sprintf(p, (type_sys == 0) ? "    %s" : " %s", type_codes[cols[k]].c_str());
+        }
+        sprintf(p, "%*s%s\n", 60 - (int)(p - buff), "", (type_sys == 0) ? "# / TYPES OF OBSERV" : "SYS / # / OBS TYPES");
+        text->append(buff);
+        nline++;
+    }
+    type_sys = -1;
+    return nline;
+}
+/*---------------------------------------------------------------------*/
+int  crx_decoder::data(char* p_sat_lst, int* sattbl, char** dflag) {
+    /********************************************************************/
+    /*  Functions                                                       */
+    /*      (1) compose the original data from 3rd order difference     */
+    /*      (2) repair the flags                                        */
+    /*  sattbl : previous column on which the satellites are set        */
+    /*           new satellites are set to -1                           */
+    /*       u : upper X digits of the data                             */
+    /*       l : lower 5 digits of the data                             */
+    /*            ( y = u*100 + l/1000)                                 */
+    /*   date of previous epoch are set to dy0                           */
+    /*  The arcs of full order of a satellite are integrated at once    */
+    /*  (arc_integrate()), the others one by one.                       */
+    /*  With type_filter, only the columns in type_cols[] are recovered */
+    /*  (and output); the others keep only their arc_order (getdiff()). */
+    /*  With stats, the fields not integrated at once are counted in    */
+    /*  the time of formatting, as they are added before putfield().    */
+    /********************************************************************/
+    field_state* ps1;
+    fixed_t** y1, ** y0;
+    const int* cols;
+    int  i, j, jo, nto, k, m, * i0, out, nf;
+    char* p, * p_line = NULL, * p_field = NULL;
+
+    for (i = 0, i0 = sattbl, p = p_sat_lst; i < nsat; i++, i0++, p += 3) {
+        if (stats != NULL) stats->enter(PHASE_ARC);
+        out = sat_out[i];       /** =0 : only the arcs and the flags are updated **/
+        /**** set # of data types for the GNSS type    ****/
+        /**** and write satellite ID in case of RINEX3 ****/
+        /**** ---------------------------------------- ****/
+        if (rinex_version >= 3) {
+            ntype = ntype_record[i];
+            if (out) {
+                strncpy(p_buff, p, C3);
+                p_buff += 3;
+            }
+        }
+        if (type_filter.empty()) {
+            cols = NULL;
+            nto = ntype;
+        }
+        else {
+            k = (rinex_version == 2) ? 0 : (unsigned char)*p;
+            cols = type_cols[k].data();
+            nto = (int)type_cols[k].size();
+        }
+        if (stats != NULL) {
+            for (j = 0; j < ntype; j++) stats->fields += (st1[i][j].arc_order >= 0);
+            p_field = p_buff;
+            p_line = (rinex_version >= 3 && out) ? p_buff - 3 : p_buff;   /** satellite ID **/
+        }
+        /**** repair the data flags ****/
+        /**** ----------------------****/
+        if (*i0 < 0) {       /* new satellite */
+            if (rinex_version >= 3) {
+                *flag[i] = '\0';
+            }
+            else {
+                sprintf(flag[i], "%-*s", ntype * 2, dflag[i]);
+            }
+        }
+        else {
+            strncpy(flag[i], flag1[*i0], ntype * C2);
+        }
+        str_repair(flag[i], dflag[i]);
+
+        /**** recover the date, and output ****/
+        /**** ---------------------------- ****/
+        y1 = &dy1[i * NPLANE];
+        y0 = (*i0 < 0) ? NULL : &dy0[*i0 * NPLANE];    /** not used for a new arc **/
+        m = -1;                 /** order of the arcs integrated at once **/
+        if (y0 != NULL) {
+            for (jo = 0; jo < nto; jo++) {
+                ps1 = &st1[i][(cols != NULL) ? cols[jo] : jo];
+                if (ps1->arc_order > 0 && ps1->order == ps1->arc_order) { m = ps1->arc_order; break; }
+            }
+            if (m > 0 && arc_integrate(y1, y0, m, (cols != NULL) ? cols[nto - 1] + 1 : ntype) != 0) m = -1;  /** out of range: one by one **/
+        }
+        if (stats != NULL) stats->enter(PHASE_FORMAT);
+        for (jo = 0; jo < nto; jo++) {
+            j = (cols != NULL) ? cols[jo] : jo;
+            ps1 = &st1[i][j];
+            if (ps1->arc_order >= 0) {
+                if (ps1->order < ps1->arc_order) {
+                    (ps1->order)++;
+                    for (k = 0; k < ps1->order; k++) y1[k + 1][j] = fixed_add(y1[k][j], y0[k][j]);
+                }
+                else if (ps1->order != m) {
+                    for (k = 0; k < ps1->order; k++) y1[k + 1][j] = fixed_add(y1[k][j], y0[k + 1][j]);
+                }
+                if (out && putfield(y1[ps1->order][j], &flag[i][j * 2]) != 0) return -1;
+            }
+            else {
+                if (crinex_version == 1) {                       /*** CRINEX 1 assumes that flags are always ***/
+                    if (out) { memset(p_buff, ' ', 16); p_buff += 16; }  /*** blank if data field is blank ***/
+                    flag[i][j * 2] = flag[i][j * 2 + 1] = ' ';
+                }
+                else if (out) {                                   /*** CRINEX 3 evaluate flags independently **/
+                    memset(p_buff, ' ', 14);
+                    p_buff[14] = flag[i][j * 2]; p_buff[15] = flag[i][j * 2 + 1];
+                    p_buff += 16;
+                }
+            }
+            if (out && ((jo + 1) == nto || (rinex_version == 2 && (jo + 1) % 5 == 0))) {
+                while (*--p_buff == ' ') {}; p_buff++;  /*** cut spaces ***/
+                *p_buff++ = '\n';
+                if (stats != NULL) {    /** flags : the 2 columns of each field not cut **/
+                    nf = (int)(p_buff - 1 - p_field);
+                    nf = 2 * (nf / 16) + (nf % 16 == 15);
+                    stats->bytes[BYTES_FLAGS] += (size_t)nf;
+                    stats->bytes[BYTES_DATA] += (size_t)(p_buff - p_line) - (size_t)nf;
+                    p_line = p_field = p_buff;
+                }
+            }
+        }
+    }
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+static char* field_end(char* p) {
+    /**** the first ' ' or '\0' from p. With SSE2, 16 bytes are compared ****/
+    /**** at a time, so 16 bytes after the end of the string must be     ****/
+    /**** readable.                                                       ****/
+#if defined(GETDIFF_SSE2)
+    const __m128i space = _mm_set1_epi8(' '), zero = _mm_setzero_si128();
+    __m128i c;
+    unsigned int m;
+
+    for (;; p += 16) {
+        c = _mm_loadu_si128((const __m128i*)p);
+        m = (unsigned int)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(c, space), _mm_cmpeq_epi8(c, zero)));
+        if (m != 0) {
+#if defined(_MSC_VER)
+            unsigned long n;
+            _BitScanForward(&n, m);
+            return p + n;
+#else
+            return p + __builtin_ctz(m);
+#endif
+        }
+    }
+#else
+    while (*p != ' ' && *p != '\0') p++;
+    return p;
+#endif
+}
+/*---------------------------------------------------------------------*/
+static int read_diff(const char* s, const char* e, fixed_t* y) {
+    /**** the value of the field s ... e-1 if it is [-]digits (up to 18  ****/
+    /**** digits), the same as read by atol() in getdiff().               ****/
+    /**** returns 0, or -1 if the field is in another form.               ****/
+    unsigned long long v;
+    unsigned int d;
+    int neg, n;
+
+    neg = (*s == '-');
+    s += neg;
+    n = (int)(e - s);
+    if (n < 1 || n > 18) return -1;
+    for (v = 0; s < e; s++) {
+        if ((d = (unsigned int)(*s - '0')) > 9) return -1;
+        v = v * 10 + d;
+    }
+    /*** as the upper and lower digits were read separately, the sign is ***/
+    /*** lost if the upper digits are zero (ex. "-000012345")           ***/
+    *y = (neg && (n < 6 || v >= 100000)) ? -(fixed_t)v : (fixed_t)v;
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+int  crx_decoder::getdiff(field_state* ps, const field_state* ps0, fixed_t* y, int i0, char* dflag, const char* use) {
+    /**** use : =0 for the types not to be output (NULL: all are output). ****/
+    /****       Only the state of their arcs is kept, not the values.     ****/
+    int j, length, rc;
+    long yu, yl;
+    char* s, * s1, * s2, line[MAXCLM + MAXTYPE];    /** >= 16 bytes after the line for field_end() **/
+
+    /******************************************************************/
+    /****  separate each field with '\0' and read the differenced   ****/
+    /****  data in one pass. Missing fields at the end are blank.   ****/
+    /******************************************************************/
+    if (stats != NULL) stats->enter(PHASE_READ);
+    rc = read_chk_line(line);
+    if (stats != NULL) stats->enter(PHASE_PARSE);
+    if (rc != 0) return rc;
+    for (j = 0, s1 = line; j < ntype; j++, ps++, ps0++, y++) {
+        s2 = field_end(s1);
+        if (*s2 == '\0') {
+            s = s2;                 /** the line ends: following fields are blank **/
+        }
+        else {
+            s = s2 + 1;
+            *s2 = '\0';
+        }
+        if (s1 == s2) {
+            ps->arc_order = -1;     /**** arc_order < 0 means that the field is blank ****/
+            ps->order = -1;
+        }
+        else {
+            if (*(s1 + 1) == '&') {     /**** arc initialization ****/
+                ps->order = -1;
+                ps->arc_order = atoi(s1);
+                s1 += 2;
+                if (stats != NULL) stats->arc_inits++;
+                if (ps->arc_order > MAX_DIFF_ORDER) return error(7, line);
+            }
+            else if (i0 < 0) {
+                if (!skip) return error(11, line);
+                warn("WARNING : New satellite, but data arc is not initialized.\n");
+                return 1;
+            }
+            else if (ps0->arc_order < 0) {
+                if (!skip) return error(12, line);
+                warn("WARNING : New data sequence but without initialization.\n");
+                return 1;
+            }
+            else {
+                ps->order = ps0->order;
+                ps->arc_order = ps0->arc_order;
+            }
+            if (use != NULL && !use[j]) {
+                s1 = s;
+                continue;
+            }
+            length = (int)(s2 - s1);
+            if (*s1 == '-') length--;
+            if (read_diff(s1, s2, y) == 0) {
+                if (length >= 6) *(s2 - 5) = '\0';    /** as below; line is shown in the error messages **/
+            }
+            else if (length < 6) {              /**** other forms as the original program ****/
+                *y = atol(s1);
+            }
+            else {
+                s2 -= 5;
+                yl = atol(s2); *s2 = '\0';
+                yu = atol(s1);
+                if (yu < 0) yl = -yl;
+                if (yu >= FIXED_LIMIT / 100000 || yu <= -FIXED_LIMIT / 100000) {
+                    *y = (yu < 0) ? -FIXED_LIMIT : FIXED_LIMIT;     /** out of range **/
+                }
+                else {
+                    *y = (fixed_t)yu * 100000 + yl;
+                }
+            }
+        }
+        s1 = s;
+    }
+    length = (int)strlen(s1);     /** flags beyond the data types have no field **/
+    if (length > dflag_table.cols() - 1) length = dflag_table.cols() - 1;
+    memcpy(dflag, s1, (size_t)length);
+    dflag[length] = '\0';
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+static char* put_f14_3(char* p, fixed_t y, const char* flag) {
+    /**** write y/1000 in F14.3 followed by 2 flags, the same as          ****/
+    /**** sprintf("%8ld %5.5ld%c%c") and moving the digits in putfield() ****/
+    /**** (-999999999999 <= y <= 9999999999999)                          ****/
+    /**** The integer part is blank if zero: "    .123", "   -.123"       ****/
+    unsigned long long n;
+    unsigned int fr;
+    const char* d;
+    char* q;
+
+    n = (unsigned long long)(y < 0 ? -y : y);
+    fr = (unsigned int)(n % 1000);
+    n /= 1000;
+    memset(p, ' ', 10);
+    q = p + 10;
+    while (n >= 100) {
+        d = digit_pairs + (n % 100) * 2;
+        n /= 100;
+        *--q = d[1];
+        *--q = d[0];
+    }
+    if (n >= 10) {
+        d = digit_pairs + n * 2;
+        *--q = d[1];
+        *--q = d[0];
+    }
+    else if (n > 0) {
+        *--q = (char)('0' + n);
+    }
+    if (y < 0) q[-1] = '-';
+
+    d = digit_pairs + (fr % 100) * 2;
+    p[10] = '.';
+    p[11] = (char)('0' + fr / 100);
+    p[12] = d[0];
+    p[13] = d[1];
+    p[14] = flag[0];
+    p[15] = flag[1];
+    p[16] = '\0';
+    return p + 16;
+}
+/*---------------------------------------------------------------------*/
+int  crx_decoder::putfield(fixed_t v, char* flag) {
+    if (v <= 9999999999999LL && v >= -999999999999LL) {   /* ex) 123.456  -123.456 */
+        p_buff = put_f14_3(p_buff, v, flag);
+        return 0;
+    }
+
+    /**** out of the range of F14.3 ****/
+    if (!output_overflow || !fixed_in_range(v)) return error(17, "Data record");
+    p_buff += sprintf(p_buff, "%8lld %5.5lld%c%c", v / 100000, llabs(v % 100000), *flag, *(flag + 1));
+    p_buff[-8] = p_buff[-7];
+    p_buff[-7] = p_buff[-6];
+    p_buff[-6] = '.';
+    warn("Warning: line %ld. : Data record becomes out of range allowed in the RINEX format. The output is corrupted.\n", nl_count);
+    exit_status = EXIT_WARNING;
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+int  crx_decoder::print_clock(fixed_t y, int shift_clk) {
+    char tmp[24], * p_tmp, * p, * p_top = p_buff;
+    long long yu, yl;
+    int n, sgn;
+
+    if (!fixed_in_range(y)) return error(17, "Clock offset");
+    yu = y / 100000000;
+    yl = y % 100000000;
+    /* The signs of yu and yl are the same (or zero) */
+
+    /** add ond more digit to handle '-0'(RINEX2) or '-0000'(RINEX3) **/
+    sgn = (yl < 0) ? -1 : 1;
+    n = sprintf(tmp, "%.*lld", shift_clk + 1, yu * 10 + sgn); /** AT LEAST fractional parts are filled with 0 **/
+    n--;                           /** n: number of digits excluding the additional digit **/
+    p_tmp = &tmp[n];
+    *p_tmp = '\0';
+    p_tmp -= shift_clk;       /** pointer to the top of last "shift_clk" digits **/
+    p_buff += sprintf(p_buff, "  .%s", p_tmp);  /** print last "shift_clk" digits.  **/
+    if (n > shift_clk) {
+        p_tmp--;
+        p = p_buff - shift_clk - 2;
+        *p = *p_tmp;
+
+        if (n > shift_clk + 1) {
+            *(p - 1) = *(p_tmp - 1);
+            if (n > shift_clk + 2) {
+                if (output_overflow) {
+                    warn("Warning: line %ld. : Clock offset becomes out of range allowed in the RINEX format. The output is corrupted.\n", nl_count);
+                    exit_status = EXIT_WARNING;
+                }
+                else {
+                    return error(17, "Clock offset");
+                }
+            }
+        }
+    }
+
+    p_buff += sprintf(p_buff, "%8.8lld\n", llabs(yl));
+    if (stats != NULL) stats->bytes[BYTES_CLOCK] += (size_t)(p_buff - p_top);
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+char* crx_decoder::get_line(char* line) {
+    /**** read one line as fgets(line, MAXCLM, ifp) and chop LF (CR/LF) ****/
+    const char* p_in, * q;
+    char* p;
+    size_t len;
+
+    if ((p_in = reader.next(MAXCLM, &len)) == NULL) return NULL;
+    memcpy(line, p_in, len);
+    line[len] = '\0';
+    if ((q = find_newline(p_in, len)) != NULL) {
+        p = line + (q - p_in);
+        if (p > line && *(p - 1) == '\r') p--;
+        *p = '\0';
+    }
+    return line;
+}
+/*---------------------------------------------------------------------*/
+int  crx_decoder::read_chk_line(char* line) {
+    const char* p_in, * q;
+    char* p;
+    size_t len;
+
+    nl_count++;
+    if ((p_in = reader.next(MAXCLM, &len)) == NULL) return error(8, line);
+    memcpy(line, p_in, len);
+    line[len] = '\0';
+    if ((q = find_newline(p_in, len)) == NULL) {
+        if (reader.get_char() == EOF) {     /** check if EOF is there **/
+            return error(8, line);
+        }
+        else {
+            if (!skip) return error(13, line);
+            return 1;
+        }
+    }
+    p = line + (q - p_in);
+    if (p > line && *(p - 1) == '\n')p--;
+    if (p > line && *(p - 1) == '\r')p--;   /*** check DOS CR/LF ***/
+    *p = '\0';
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+void crx_decoder::warn(const char* format, long n) {
+    /**** format : message with one "%ld" (line number n) or none.  ****/
+    /**** The messages of a segment (-J) are kept for the line number ****/
+    /**** from the top of the file and printed by recover_parallel(). ****/
+    if (defer_messages) {
+        deferred_message m = { format, n };
+        messages.push_back(m);
+    }
+    else {
+        fprintf(stderr, format, n);
+    }
+}
+/*---------------------------------------------------------------------*/
+int  crx_decoder::error(int error_no, const char* string) {
+    /**** keep the error for print_error() and return -1 to the caller ****/
+    err_no = error_no;
+    err_line = nl_count;
+    strncpy(err_string, string, C1 * (MAXCLM - 1));
+    err_string[MAXCLM - 1] = '\0';
+    return -1;
+}
+/*---------------------------------------------------------------------*/
+void crx_decoder::print_error(FILE* fp) const {
+    const char* string = err_string;
+
+    if (err_no == 5) {
+        fprintf(fp, "ERROR : The file format is not Compact RINEX or the version of\n");
+        fprintf(fp, "        the format is not valid. This software can deal with\n");
+        fprintf(fp, "        only Compact RINEX format ver.%s.\n", string);
+    }
+    if (err_no == 6) {
+        fprintf(fp, "ERROR at line %ld : exceed maximum number of satellites(%d)\n", err_line, MAXSAT);
+        fprintf(fp, "      start>%s<end\n", string);
+    }
+    if (err_no == 7) {
+        fprintf(fp, "ERROR at line %ld : exceed maximum order of difference (%d)\n", err_line, MAX_DIFF_ORDER);
+        fprintf(fp, "      start>%s<end\n", string);
+    }
+    if (err_no == 8) {
+        fprintf(fp, "ERROR : The file seems to be truncated in the middle.\n");
+        fprintf(fp, "        The conversion is interrupted after reading the line %ld :\n", err_line);
+        fprintf(fp, "      start>%s<end\n", string);
+    }
+    if (err_no == 9) {
+        fprintf(fp, "ERROR at line %ld : The arc should be initialized, but not.\n", err_line);
+        fprintf(fp, "      start>%s<end\n", string);
+    }
+    if (err_no == 11) {
+        fprintf(fp, "ERROR at line %ld : New satellite, but data arc is not initialized.\n", err_line);
+        fprintf(fp, "      start>%s<end\n", string);
+    }
+    if (err_no == 12) {
+        fprintf(fp, "ERROR at line %ld : The data field in previous epoch is blank, but the arc is not initialized.\n", err_line);
+        fprintf(fp, "      start>%s<end\n", string);
+    }
+    if (err_no == 13) {
+        fprintf(fp, "ERROR at line %ld : null character is found in the line or the line is too long (>%d) at line.\n", err_line, MAXCLM);
+        fprintf(fp, "      start>%s<end\n", string);
+    }
+    if (err_no == 15) {
+        fprintf(fp, "ERROR : The format version of the original RINEX file is not valid.\n");
+        fprintf(fp, "         This software can deal with only (compressed) RINEX format ver.%s.\n", string);
+    }
+    if (err_no == 16) {
+        fprintf(fp, "ERROR at line %ld. : Number of data types exceed MAXTYPE(%d).\n", err_line, MAXTYPE);
+        fprintf(fp, "     start>%s<end\n", string);
+    }
+    if (err_no == 17) {
+        fprintf(fp, "ERROR at line %ld. : %s becomes out of range allowed in the RINEX format.\n", err_line, string);
+    }
+    if (err_no == 20) {
+        fprintf(fp, "ERROR at line %ld. : A GNSS type not defined in the header is found.\n", err_line);
+        fprintf(fp, "     start>%s<end\n", string);
+    }
+    if (err_no == 21) {
+        fprintf(fp, "ERROR at line %ld. : memory for the data of the epoch can not be allocated.\n", err_line);
+        fprintf(fp, "     start>%s<end\n", string);
+    }
+}
+/*---------------------------------------------------------------------*/
+int  crx_decoder::at_bound(void) {
+    /**** =1 if the next line is the top of one of the next segments ****/
+    unsigned long long pos = reader.tell();
+
+    while (next_bound < nbound && bound[next_bound] < pos) next_bound++;
+    return next_bound < nbound && bound[next_bound] == pos;
+}
+/*---------------------------------------------------------------------*/
+static int init_epoch_line(const char* p, size_t n, const char* clk, size_t nclk, char top, int rinex_version) {
+    /**** =1 if the line p[0...n-1] looks like the epoch line of an      ****/
+    /**** initialized epoch (the checks in the main loop), has the whole ****/
+    /**** list of the satellites, and the clock clk[0...nclk-1] is blank ****/
+    /**** or initialized. Nothing is then taken from the previous epochs. ****/
+    size_t offset = (rinex_version == 2) ? 3 : 6, satlst = (rinex_version == 2) ? 32 : 41;
+    const char* q = p + offset;
+    int nsat;
+
+    if (n > 0 && p[n - 1] == '\r') n--;
+    if (nclk > 0 && clk[nclk - 1] == '\r') nclk--;
+    if (*p != top || n < offset + 29) return 0;
+    if (*q != ' ' || q[3] != ' ' || q[6] != ' ' || q[9] != ' ' || q[12] != ' '
+        || q[23] != ' ' || q[24] != ' ' || (q[25] != '0' && q[25] != '1')) return 0;
+    nsat = atoi(q + 26);
+    if (nsat <= 0 || nsat > MAXSAT || n < satlst + (size_t)nsat * 3) return 0;
+    return nclk == 0 || (nclk > 1 && clk[1] == '&');
+}
+/*---------------------------------------------------------------------*/
+static size_t find_init_epoch(const char* map, size_t size, size_t from, char top, int rinex_version) {
+    /**** offset of the first initialized epoch at or after "from" ****/
+    /**** (size if not found)                                      ****/
+    const char* p, * e, * e2, * end = map + size;
+
+    if (from == 0 || from >= size) return size;
+    p = map + from;
+    if (p[-1] != '\n') {                /** go to the top of the next line **/
+        if ((p = (const char*)memchr(p, '\n', (size_t)(end - p))) == NULL) return size;
+        p++;
+    }
+    for (; p < end; p = e + 1) {
+        if ((e = (const char*)memchr(p, '\n', (size_t)(end - p))) == NULL) break;
+        if (*p != top) continue;
+        if ((e2 = (const char*)memchr(e + 1, '\n', (size_t)(end - e - 1))) == NULL) break;
+        if (init_epoch_line(p, (size_t)(e - p), e + 1, (size_t)(e2 - e - 1), top, rinex_version)) return (size_t)(p - map);
+    }
+    return size;
+}
+/*---------------------------------------------------------------------*/
+int  crx_decoder::decode_segment(const char* map, size_t size, const unsigned long long* b, int nb, std::string* out) {
+    /**** recover the epochs from the offset b[0] into "out", up to one   ****/
+    /**** of b[1] ... b[nb-1] reached just at the top of an epoch (or to ****/
+    /**** the end). The header is read again for the observation types.  ****/
+    int i, rc;
+
+    init_state();
+    reader.open_memory(map, size);
+    writer.open_memory(out, MIN_BLOCK_SIZE);
+    if (stats != NULL) stats->start();
+    for (i = 0; i < UCHAR_MAX; i++) ntype_gnss[i] = -1;
+    if (header() != 0) {
+        rc = EXIT_FAILURE;
+    }
+    else {
+        writer.flush();
+        out->clear();               /** the header is output by the caller **/
+        reader.seek(b[0]);
+        nl_count = 0;
+        bound = b + 1;
+        nbound = nb - 1;
+        rc = epochs();
+    }
+    if (stats != NULL) stats->stop(writer.tell());
+    writer.close();
+    reader.close();
+    return rc;
+}
+/*---------------------------------------------------------------------*/
+int  crx_decoder::recover_parallel(void) {
+    /**********************************************************************/
+    /*  Recover a mapped file in segments by "nthread" threads.           */
+    /*  The segments start at initialized epochs found about every        */
+    /*  SEGMENT_SIZE bytes. A segment is recovered until the decoder is   */
+    /*  just at the top of the start of a later segment, which is then    */
+    /*  known to be an epoch, so the segments in between (started at a   */
+    /*  line that only looked like an epoch) are discarded. After a change */
+    /*  of the observation types, a segment is recovered to the end.      */
+    /*  The text of the segments is output in order; at most 2*nthread    */
+    /*  segments are held at once.                                        */
+    /**********************************************************************/
+    std::vector<unsigned long long> b;
+    std::vector<crx_decoder*> part;
+    std::vector<std::string> text;
+    std::vector<int> rcs;
+    std::vector<std::thread> workers;
+    std::vector<conv_stats> part_stats;
+    std::unique_ptr<std::atomic<int>[]> done;
+    std::atomic<int> next(0), consumed(0), cancel(0);
+    const char* map = reader.map_data();
+    size_t size = reader.map_length(), seg, t;
+    long base_line;
+    int i, k, m, n, nseg, rc = EXIT_SUCCESS;
+    char top;
+
+    for (i = 0; i < UCHAR_MAX; i++) ntype_gnss[i] = -1;
+    if (header() != 0) return EXIT_FAILURE;
+
+    /**** start of the segments ****/
+    top = (rinex_version == 2) ? '&' : '>';
+    b.push_back(reader.tell());
+    seg = (size_t)(size - b[0]) / ((size_t)nthread * 4);
+    if (seg < SEGMENT_MIN_SIZE) seg = SEGMENT_MIN_SIZE;
+    if (seg > SEGMENT_MAX_SIZE) seg = SEGMENT_MAX_SIZE;
+    while ((t = find_init_epoch(map, size, (size_t)b.back() + seg, top, rinex_version)) < size) b.push_back(t);
+    nseg = (int)b.size();
+    if (nseg < 2) return epochs();
+
+    part.assign(nseg, NULL);
+    text.resize(nseg);
+    rcs.assign(nseg, EXIT_SUCCESS);
+    if (stats != NULL) part_stats.resize(nseg);
+    done.reset(new std::atomic<int>[nseg]);
+    for (k = 0; k < nseg; k++) done[k] = 0;
+
+    for (i = 0; i < nthread && i < nseg; i++) {
+        workers.emplace_back([&]() {
+            int j, n;
+            while ((j = next++) < nseg) {
+                for (n = 0; j >= consumed + 2 * nthread && !cancel; n++) ring_wait(n);
+                if (!cancel) {
+                    part[j] = new crx_decoder;
+                    part[j]->block_size = block_size;
+                    part[j]->defer_messages = 1;
+                    part[j]->sat_filter = sat_filter;
+                    part[j]->type_filter = type_filter;
+                    part[j]->stats = (stats != NULL) ? &part_stats[j] : NULL;
+                    rcs[j] = part[j]->decode_segment(map, size, &b[j], nseg - j, &text[j]);
+                }
+                done[j].store(1, std::memory_order_release);
+            }
+        });
+    }
+
+    /**** output the segments in order ****/
+    base_line = nl_count;
+    for (k = 0; k < nseg; k = m) {
+        for (i = 0; !done[k].load(std::memory_order_acquire); i++) ring_wait(i);
+        for (i = 0; i < (int)part[k]->messages.size(); i++) {
+            fprintf(stderr, part[k]->messages[i].format, part[k]->messages[i].line + base_line);
+        }
+        if (stats != NULL) stats->enter(PHASE_OUTPUT);
+        writer.write(text[k].data(), text[k].size());
+        if (stats != NULL) {
+            stats->enter(PHASE_OTHER);
+            stats->add(part_stats[k]);
+        }
+        if (rcs[k] == EXIT_FAILURE) {
+            err_no = part[k]->err_no;
+            err_line = part[k]->err_line + base_line;
+            strcpy(err_string, part[k]->err_string);
+            rc = EXIT_FAILURE;
+            break;
+        }
+        if (rcs[k] == EXIT_WARNING) rc = EXIT_WARNING;
+        base_line += part[k]->nl_count;
+        normal_end = part[k]->normal_end;
+        m = part[k]->stopped ? k + 1 + part[k]->next_bound : nseg;
+        for (i = k; i < m; i++) {       /** (k+1 ... m-1 : discarded) **/
+            for (n = 0; !done[i].load(std::memory_order_acquire); n++) ring_wait(n);
+            delete part[i];
+            part[i] = NULL;
+            std::string().swap(text[i]);
+            consumed = i + 1;
+        }
+    }
+    cancel = 1;
+    for (i = 0; i < (int)workers.size(); i++) workers[i].join();
+    for (k = 0; k < nseg; k++) delete part[k];
+    return rc;
+}
@@ -0,0 +1,187 @@
+/****************************************************************************/
+/*     crx_decoder : recovery of the RINEX file from Compact RINEX file     */
+/*                                                                          */
+/*     All the state needed for one conversion is held in a crx_decoder     */
+/*     object, and errors are reported as return values instead of exit(), */
+/*     so that several files can be decoded concurrently in one process.    */
+/*                                                                          */
+/*     Copyright (c) 2007 Geospatial Information Authority of Japan         */
+/****************************************************************************/
+#ifndef CRX_DECODER_H
+#define CRX_DECODER_H
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "../common/arc_kernel.h"
+#include "../common/block_writer.h"
+#include "../common/conv_stats.h"
+#include "../common/crx_index.h"
+#include "../common/epoch_table.h"
+#include "../common/fixed_value.h"
+#include "../common/line_reader.h"
+#include "../common/sat_index.h"
+
+#define VERSION  "ver.4.1.0"
+
+/**** Exit codes are defined here. ****/
+#ifndef EXIT_SUCCESS
+#define EXIT_SUCCESS 0
+#endif
+
+#ifndef EXIT_FAILURE
+#define EXIT_FAILURE 1
+#endif
+
+#define EXIT_WARNING 2
+
+/* define global constants */
+#define PROGNAME "CRX2RNX"
+#define MAXSAT    999         /* Maximum number of satellites observed at one epoch (I3) */
+#define MAXTYPE   999         /* Maximum number of data types   */
+#define MAXCLM   2048         /* Maximum columns in one line */
+#define NSAT_INIT  16         /* satellites allocated first (enlarged on demand) */
+#define MAX_DIFF_ORDER 5      /* Maximum order of difference to be dealt with */
+#define SEGMENT_MIN_SIZE  (1 << 20)   /* size of the segments recovered in parallel (-J) */
+#define SEGMENT_MAX_SIZE  (16 << 20)
+
+/* define data structure for fields of clock offset and observation records */
+/* Each value is held in one 64-bit integer (see fixed_value.h).             */
+/* The names differ from those of RNX2CRX, into which the decoder is also   */
+/* linked for "RNX2CRX -v" (epoch_table<field_state> is then a distinct     */
+/* template instance).                                                      */
+typedef struct clock_state {
+    fixed_t y[MAX_DIFF_ORDER + 1];   /* all digits for each difference order */
+} clock_state;
+
+/* The values of the data fields are held in planes (see arc_kernel.h):     */
+/* dy[i * NPLANE + k][j] is the k-th difference (data*1000) of the j-th     */
+/* data type of the i-th satellite. field_state is the state of a field.    */
+typedef struct field_state {
+    int  order;
+    int  arc_order;
+} field_state;
+
+#define NPLANE (MAX_DIFF_ORDER + 1)     /* planes of the differences of one satellite */
+
+/****************************************************************************/
+/*  crx_decoder                                                             */
+/*    convert() reads a Compact RINEX file from "in" and writes the         */
+/*    recovered RINEX file to "out". The return value is EXIT_SUCCESS,      */
+/*    EXIT_WARNING or EXIT_FAILURE; print_error() prints the message for    */
+/*    EXIT_FAILURE. The tables of the data are allocated for the number of  */
+/*    data types in the header and enlarged when more satellites appear.    */
+/****************************************************************************/
+class crx_decoder {
+public:
+    crx_decoder();
+    ~crx_decoder();
+
+    int  convert(FILE* in, FILE* out);
+    void print_error(FILE* fp) const;
+    int  set_filter(const char* systems, const char* prns);    /* satellites to be output */
+    int  set_types(const char* types);  /* observation types to be output */
+
+    int  skip;                  /* skip strange epochs (-s) */
+    int  output_overflow;       /* keep output even if it exceeds the RINEX format */
+    int  err_no;                /* error number of the last failure (0: no error) */
+    int  normal_end;            /* =1 if the conversion reached the end of the file */
+                                /* normally (i.e. the input may be deleted by -d)   */
+    int  use_mmap;              /* read the input through a memory mapping if possible */
+    size_t block_size;          /* size of the output block (bytes) */
+    int  flush_epoch;           /* write the output at every epoch */
+    int  pipeline;              /* read, convert and write in 3 threads (-p) */
+    int  use_window;            /* output only the epochs from t_start to t_end (-t) */
+    epoch_time t_start, t_end;
+    const crx_index* index;     /* index of the input file (NULL: not available) */
+    int  nthread;               /* recover one mapped file in segments by # threads (-J #) */
+    conv_stats* stats;          /* time of the phases and counts (--stats), NULL: not taken */
+
+private:
+    line_reader reader;
+    block_writer writer;
+
+    clock_state clk1, clk0;
+    /**** data and flags of the current and the previous epoch.          ****/
+    /**** They are two banks and the pointers are exchanged at the end    ****/
+    /**** of an epoch instead of copying the tables. The rows of the      ****/
+    /**** previous epoch are reached through sattbl (set_sat_table()).    ****/
+    epoch_table<fixed_t> dy_bank[2];        /* NPLANE rows for each satellite */
+    epoch_table<field_state> st_bank[2];
+    epoch_table<char> flag_bank[2];
+    epoch_table<char> dflag_table;
+    int bank;                   /* bank of the current epoch */
+    fixed_t** dy1, ** dy0;
+    field_state** st1, ** st0;
+    char** flag1, ** flag, ** dflag;
+
+    int rinex_version, crinex_version;
+    int nsat, ntype, ntype_gnss[UCHAR_MAX], ntype_record[MAXSAT], clk_order, clk_arc_order;
+    int ntype_max;              /* largest number of data types in the header (and events) */
+    char ep_top_from, ep_top_to;
+    long nl_count;
+    int exit_status;
+
+    char line[MAXCLM], dline[MAXCLM], sat_lst_old[MAXSAT * 3];
+    int nsat1;
+    sat_index sat_old;          /* index of sat_lst_old */
+
+    char* out_buff, * p_buff;
+    size_t out_size;
+    double key_start, key_end;  /* time_key() of t_start and t_end */
+    int muted;                  /* =1 before the time window (nothing is output) */
+    std::vector<char> sat_filter;   /* [system * 100 + PRN] =1 output (empty: all satellites) */
+    char sat_out[MAXSAT];       /* =1 output the i-th satellite of the epoch */
+    std::vector<std::string> type_filter;   /* observation types to be output (empty: all types) */
+    std::vector<char> type_out[UCHAR_MAX + 1];  /* [system][j] =1 output the j-th type ([0]: RINEX2) */
+    std::vector<int> type_cols[UCHAR_MAX + 1];  /* columns of the types to be output */
+    int type_sys;               /* system of the list of the types being read (-1: none) */
+    int type_count;             /* number of the types in the list */
+    std::vector<std::string> type_codes;    /* types of the list read so far */
+    const unsigned long long* bound;    /* offsets at which a segment stops (see epochs()) */
+    int nbound, next_bound;     /* number of them, and the first one not yet passed */
+    int stopped;                /* =1 if stopped at bound[next_bound] */
+    int defer_messages;         /* =1 keep the warnings in "messages" instead of printing */
+    struct deferred_message {
+        const char* format;     /* format of warn() */
+        long line;              /* line number from the top of the segment */
+    };
+    std::vector<deferred_message> messages;
+
+    long err_line;              /* line number at which the error was detected */
+    char err_string[MAXCLM];    /* copy of the offending text for print_error() */
+
+    void init_state(void);
+    int  recover(void);
+    int  recover_parallel(void);
+    int  decode_segment(const char* map, size_t size, const unsigned long long* b, int nb, std::string* out);
+    int  epochs(void);
+    int  at_bound(void);
+    int  header(void);
+    int  put_event_data(char* dline, char* p_event);
+    int  skip_to_next(char* dline);
+    void seek_window(void);
+    int  window_state(const char* epoch_line) const;
+    void process_clock(void);
+    int  set_sat_table(char* p_new, char* p_old, int nsat1, int* sattbl);
+    int  select_sats(const char* p_satlst);
+    int  put_header_line(const char* line, std::string* text);
+    int  put_types(std::string* text);
+    int  data(char* p_sat_lst, int* sattbl, char** dflag);
+    int  getdiff(field_state* ps, const field_state* ps0, fixed_t* y, int i0, char* dflag, const char* use);
+    int  putfield(fixed_t v, char* flag);
+    void put_epoch(void);
+    void swap_epoch(void);
+    int  reserve_epoch(int n);
+    int  read_clock(char* dline, fixed_t* y);
+    int  print_clock(fixed_t y, int shift_clk);
+    char* get_line(char* line);
+    int  read_chk_line(char* line);
+    void warn(const char* format, long n = 0);
+    int  error(int error_no, const char* string);
+};
+
+#endif
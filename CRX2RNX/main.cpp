@@ -51,230 +51,135 @@
 /*                    files from CRINEX ver.3 files.                        */
 /*                 2022-01-06                Y. Hatanaka                    */
 /*                  - VERSION is corrected to 4.1.0                         */
+/*                 2026-10-16                                               */
+/*                  - several input files (or a list of them given by "-l") */
+/*                    are converted in parallel by a pool of worker threads */
+/*                    ("-j #"), and the exit code of each file is reported. */
+/*                  - input is read from a memory-mapped file, and output   */
+/*                    is written in large blocks ("-b #" MB, 1-8) or at     */
+/*                    every epoch ("-u").                                   */
+/*                  - the input, the conversion and the output of one file  */
+/*                    can run in separate threads ("-p").                   */
+/*                  - only the epochs in a time window are recovered        */
+/*                    ("-t"), starting from an initialized epoch found in   */
+/*                    the index made by "RNX2CRX -x" if it is there.        */
+/*                  - one file can be recovered in segments starting at     */
+/*                    initialized epochs by several threads ("-J #").       */
+/*                  - only the satellites of the given GNSS systems ("-G")  */
+/*                    or in the given list ("-P") are output.               */
+/*                  - only the given observation types are recovered and    */
+/*                    output ("-O").                                        */
+/*                  - the time of each phase of the conversion, the counts  */
+/*                    of epochs, satellites, fields, etc. and the output    */
+/*                    bytes by category are printed ("--stats").            */
 /*                                                                          */
 /*     Copyright (c) 2007 Geospatial Information Authority of Japan         */
 /*                                                                          */
 /****************************************************************************/
 
-#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <mutex>
+#include <string>
+#include <vector>
 
-#define VERSION  "ver.4.1.0"
+#include "crx_decoder.h"
+#include "../common/thread_pool.h"
 
-/**** Exit codes are defined here. ****/
-#ifndef EXIT_SUCCESS
-#define EXIT_SUCCESS 0
-#endif
-
-#ifndef EXIT_FAILURE
-#define EXIT_FAILURE 1
-#endif
-
-#define EXIT_WARNING 2
-
-/*** define macros ***/
-/* #define CHOP_LF(q,p) p = strchr(q,'\n'); *p = '\0'; */
-#define CHOP_LF(q,p) p = strchr(q,'\n'); if(p != NULL){if( *(p-1) == '\r' && p>q )p--;*p = '\0';}
-#define CHOP_BLANK(q,p) p = strchr(q,'\0');while(*--p == ' ' && p>q);*++p = '\0'
-
-/* define global constants */
-#define PROGNAME "CRX2RNX"
-#define MAXSAT    100         /* Maximum number of satellites observed at one epoch */
-#define MAXTYPE   100         /* Maximum number of data types   */
-#define MAXCLM   2048         /* Maximum columns in one line   (>MAXTYPE*19+3)  */
-#define MAX_BUFF_SIZE 204800  /* Maximum size of output buffer (>MAXSAT*(MAXTYPE*19+4)+60 */
-#define MAX_DIFF_ORDER 5      /* Maximum order of difference to be dealt with */
-
-/* define data structure for fields of clock offset and observation records */
-typedef struct clock_format {
-    long u[MAX_DIFF_ORDER + 1];      /* upper X digits for each difference order */
-    long l[MAX_DIFF_ORDER + 1];      /* lower 8 digits */
-} clock_format;
-
-typedef struct data_format {
-    long u[MAX_DIFF_ORDER + 1];      /* upper X digits for each difference order */
-    long l[MAX_DIFF_ORDER + 1];      /* lower 5 digits */
-    int  order;
-    int  arc_order;
-} data_format;
-
-/* define global variables */
-clock_format clk1, clk0;
-data_format dy1[MAXSAT][MAXTYPE], dy0[MAXSAT][MAXTYPE];
-char flag1[MAXSAT][MAXTYPE * 2 + 1], flag[MAXSAT][MAXTYPE * 2 + 1];
-
-int rinex_version, crinex_version;
-int nsat, ntype, ntype_gnss[UCHAR_MAX], ntype_record[MAXSAT], clk_order = 0, clk_arc_order = 0;
-char ep_top_from, ep_top_to;
-long nl_count = 0;
+/* define global variables (the state of the conversion is in crx_decoder) */
 int skip = 0;
 int output_overflow = 0;
 int exit_status = EXIT_SUCCESS;
 int delete_if_no_error = 0; /* default : not delete */
-int n_infile = 0;           /* number of input file (must be 0 or 1) */
-char infile[MAXCLM];        /**** name of input file ****/
-size_t C1 = sizeof("");               /* size of one character */
-size_t C2 = sizeof(" ");              /* size of 2-character string */
-size_t C3 = sizeof("  ");             /* size of 3-character string */
-
-char out_buff[MAX_BUFF_SIZE], * p_buff;
+int force = 0;              /* overwrite if the output file exists */
+int nfout = 0;              /* =0 default output file name, =1 standard output */
+int nthread = 0;            /* number of worker threads (0: number of CPUs) */
+size_t block_size = DEFAULT_BLOCK_SIZE;  /* size of the output block */
+int flush_epoch = 0;        /* =1 flush the output at every epoch */
+int pipeline = 0;           /* =1 read, convert and write in separate threads */
+int nthread_file = 0;       /* threads recovering the segments of one file (-J #) */
+int use_window = 0;         /* =1 output only the epochs in the time window */
+epoch_time t_start, t_end;  /* time window */
+const char* systems = NULL; /* GNSS systems to be output (-G), NULL: all */
+const char* prns = NULL;    /* satellites to be output (-P), NULL: all */
+const char* types = NULL;   /* observation types to be output (-O), NULL: all */
+int show_stats = 0;         /* =1 print the time of the phases and the counts (--stats) */
+std::vector<std::string> infiles;   /**** names of input files ****/
+std::vector<std::string> outfiles;  /**** names of output files ("": not converted) ****/
+std::vector<int> status;            /**** exit code of each file ****/
+std::mutex err_mutex;               /**** serializes messages from the workers ****/
 
 /* declaration of functions */
-void fileopen(int argc, char* argv[]);
-void header(void);
-int  put_event_data(char* dline, char* p_event);
-void skip_to_next(char* dline);
-void process_clock(void);
-void set_sat_table(char* p_new, char* p_old, int nsat1, int* sattbl);
-void data(char* p_sat_lst, int* sattbl, char dflag[][MAXTYPE * 2]);
-void repair(char* s, char* ds);
-int  getdiff(data_format* y, data_format* dy0, int i0, char* dflag);
-void putfield(data_format* y, char* flag);
-void read_clock(char* dline, long* yu, long* yl);
-void print_clock(long yu, long yl, int shift_clk);
-int  read_chk_line(char* line);
+void parse_args(int argc, char* argv[]);
+void read_list(const char* listfile);
+int  set_outfile(size_t n);
+int  convert_file(size_t n);
+void file_error(int error_no, const char* string);
+void report_stats(const char* name, const conv_stats* stats);
 void error_exit(int error_no, const char* string);
-void no_error_exit();
 
 /*---------------------------------------------------------------------*/
 int main(int argc, char* argv[]) {
-    static char line[MAXCLM] = "", sat_lst_old[MAXSAT * 3];
-    static int nsat1 = 0, n;
-
-    char dline[MAXCLM], * p;
-    int sattbl[MAXSAT], i, j, * i0;
-    size_t offset;
-    char dflag[MAXSAT][MAXTYPE * 2];
-    char* p_event, * p_nsat, * p_satlst, shift_clk;
-    /* sattbl[i]: order (at the previous epoch) of i-th satellite */
-    /* (at the current epoch). -1 is set for the new satellites   */
-
-    fileopen(argc, argv);
-    for (i = 0; i < UCHAR_MAX; i++)ntype_gnss[i] = -1;  /** -1 unless GNSS type is defined **/
-    header();
-    if (rinex_version == 2) {
-        ep_top_from = '&';
-        ep_top_to = ' ';
-        p_event = &dline[28];  /** pointer to event flug **/
-        p_nsat = &line[29];  /** pointer to n_sat **/
-        p_satlst = &line[32];  /** pointer to address to add satellite list **/
-        shift_clk = 1;
-        offset = 3;
-    }
-    else {
-        ep_top_from = '>';
-        ep_top_to = '>';
-        p_event = &dline[31];
-        p_nsat = &line[32];
-        p_satlst = &line[41];
-        shift_clk = 4;
-        offset = 6;
-    }
-
-    while (fgets(dline, MAXCLM, stdin) != NULL) {      /*** exit program successfully ***/
-        nl_count++;
-        CHOP_LF(dline, p);
-    SKIP:
-        if (crinex_version == 3) { /*** skip escape lines of CRINEX version 3 ***/
-            while (dline[0] == '&') {
-                nl_count++;
-                if (fgets(dline, MAXCLM, stdin) == NULL) no_error_exit();
-                CHOP_LF(dline, p);
-            }
-        }
-        if (dline[0] == ep_top_from) {
-            dline[0] = ep_top_to;
-            if (*p_event != '0' && *p_event != '1') {
-                if (put_event_data(dline, p_event) != 0) skip_to_next(dline);
-                goto SKIP;
-            }
-            line[0] = '\0';          /**** initialize arc for epoch data ***/
-            nsat1 = 0;               /**** initialize the all satellite arcs ****/
-        }
-        else if (dline[0] == '\032') {
-            no_error_exit();   /** DOS EOF **/
-        }
-        /****  read, repair the line  ****/
-        repair(line, dline);
-        p = &line[offset];  /** pointer to the space between year and month **/
-        if (line[0] != ep_top_to || strlen(line) < (26 + offset) || *(p + 23) != ' '
-            || *(p + 24) != ' ' || !isdigit(*(p + 25))) {
-            skip_to_next(dline);
-            goto SKIP;
-        }
-        CHOP_BLANK(line, p);
-
-        nsat = atoi(p_nsat);
-        if (nsat > MAXSAT) error_exit(6, p_nsat);
-
-        set_sat_table(p_satlst, sat_lst_old, nsat1, sattbl); /****  set satellite table  ****/
-        if (read_chk_line(dline) != 0) { skip_to_next(dline); goto SKIP; }
-        read_clock(dline, clk1.u, clk1.l);
-        for (i = 0, i0 = sattbl; i < nsat; i++, i0++) {
-            ntype = ntype_record[i];
-            if (getdiff(dy1[i], dy0[*i0], *i0, dflag[i]) != 0) { skip_to_next(dline); goto SKIP; }
-        }
-
-        /*************************************/
-        /**** print the recovered line(s) ****/
-        /*************************************/
-        if (dline[0] != '\0') process_clock();
-        p_buff = out_buff;
-
-        if (rinex_version == 2) {
-            if (clk_order >= 0) {
-                p_buff += sprintf(p_buff, "%-68.68s", line);
-                print_clock(clk1.u[clk_order], clk1.l[clk_order], shift_clk);
-            }
-            else {
-                p_buff += sprintf(p_buff, "%.68s\n", line);
-            }
-            for (p = &line[68], n = nsat - 12; n > 0; n -= 12, p += 36) p_buff += sprintf(p_buff, "%32.s%.36s\n", " ", p);
-        }
-        else {
-            if (clk_order >= 0) {
-                p_buff += sprintf(p_buff, "%.41s", line);
-                print_clock(clk1.u[clk_order], clk1.l[clk_order], shift_clk);
-            }
-            else {
-                sprintf(p_buff, "%.41s", line);
-                CHOP_BLANK(p_buff, p); *p++ = '\n'; p_buff = p;
-            }
-        }
-
-        data(p_satlst, sattbl, dflag);
-
-        *p_buff = '\0'; printf("%s", out_buff);
-        /****************************/
-        /**** save current epoch ****/
-        /****************************/
-        nsat1 = nsat;
-        clk0 = clk1;
-        strncpy(sat_lst_old, p_satlst, nsat * C3);
-        for (i = 0; i < nsat; i++) {
-            strncpy(flag1[i], flag[i], ntype_record[i] * C2);
-            for (j = 0; j < ntype_record[i]; j++) dy0[i][j] = dy1[i][j];
+    crx_decoder* decoder;
+    conv_stats stats;
+    size_t i, n;
+
+    parse_args(argc, argv);
+
+    n = infiles.size();
+    if (n == 0) {  /*** stdin & stdout will be used if input file name is not given ***/
+        decoder = new crx_decoder;
+        decoder->skip = skip;
+        decoder->output_overflow = output_overflow;
+        decoder->block_size = block_size;
+        decoder->flush_epoch = flush_epoch;
+        decoder->pipeline = pipeline;
+        decoder->nthread = nthread_file;
+        decoder->set_filter(systems, prns);
+        decoder->set_types(types);
+        decoder->use_window = use_window;
+        decoder->t_start = t_start;
+        decoder->t_end = t_end;
+        if (show_stats) decoder->stats = &stats;
+        exit_status = decoder->convert(stdin, stdout);
+        if (exit_status == EXIT_FAILURE) decoder->print_error(stderr);
+        if (show_stats) report_stats(NULL, &stats);
+        delete decoder;
+        exit(exit_status);
+    }
+
+    outfiles.resize(n);
+    status.resize(n);
+    for (i = 0; i < n; i++) status[i] = set_outfile(i);
+
+    parallel_for(n, nthread, [](size_t k) {
+        if (status[k] == EXIT_SUCCESS && (nfout || !outfiles[k].empty())) status[k] = convert_file(k);
+    });
+
+    for (i = 0; i < n; i++) {
+        if (n > 1) fprintf(stderr, "%s : exit code = %d\n", infiles[i].c_str(), status[i]);
+        if (status[i] == EXIT_FAILURE) {
+            exit_status = EXIT_FAILURE;
+        }
+        else if (status[i] == EXIT_WARNING && exit_status == EXIT_SUCCESS) {
+            exit_status = EXIT_WARNING;
         }
     }
-    no_error_exit();
+    exit(exit_status);
 }
 /*---------------------------------------------------------------------*/
-void fileopen(int argc, char* argv[]) {
-    char* p, outfile[MAXCLM], * progname;
-    int force = 0, help = 0;
-    int nfout = 0;  /*** =0 default output file name ***/
-    /*** =1 standard output          ***/
-    FILE* ifp;
+void parse_args(int argc, char* argv[]) {
+    char* progname;
+    int help = 0, mbyte;
 
     progname = argv[0];
     argc--; argv++;
     for (; argc > 0; argc--, argv++) {
         if ((*argv)[0] != '-') {
-            strncpy(infile, *argv, C1 * MAXCLM);
-            n_infile++;
+            if (strlen(*argv) >= MAXCLM) error_exit(14, *argv);
+            infiles.push_back(*argv);
         }
         else if (strcmp(*argv, "-") == 0) {
             nfout = 1;
@@ -295,531 +200,215 @@ void fileopen(int argc, char* argv[]) {
             /* (a hidden option for checking)                          */
             output_overflow = 1;
         }
-        else if (strcmp(*argv, "-h") == 0) {
-            help = 1;
+        else if (strcmp(*argv, "--stats") == 0) {
+            show_stats = 1;
         }
-        else {
-            help = 1;
+        else if (strcmp(*argv, "-l") == 0 && argc > 1) {
+            argc--; argv++;
+            read_list(*argv);
         }
-    }
-
-    if (strlen(infile) == MAXCLM)error_exit(14, infile);
-    if (help == 1 || n_infile > 1 || n_infile < 0) error_exit(1, progname);
-    if (n_infile == 0) return;  /*** stdin & stdout will be used if input file name is not given ***/
-
-    /***********************/
-    /*** open input file ***/
-    /***********************/
-    p = strrchr(infile, '.');
-    if (p == NULL || *(p + 4) != '\0'
-        || (toupper(*(p + 3)) != 'D'
-            && strcmp(p + 1, "CRX") != 0
-            && strcmp(p + 1, "crx") != 0)
-        ) error_exit(3, p);
-
-    if ((ifp = fopen(infile, "r")) == NULL) error_exit(4, infile);
-
-    /************************/
-    /*** open output file ***/
-    /************************/
-    if (nfout == 0) {
-        strcpy(outfile, infile);
-        p = strrchr(outfile, '.');
-        if (*(p + 3) == 'd') { *(p + 3) = 'o'; }
-        else if (*(p + 3) == 'D') { *(p + 3) = 'O'; }
-        else if (strcmp(p + 1, "crx") == 0) { strcpy((p + 1), "rnx"); }
-        else if (strcmp(p + 1, "CRX") == 0) { strcpy((p + 1), "RNX"); }
-
-        if ((freopen(outfile, "r", stdout)) != NULL && force == 0) {
-            fprintf(stderr, "The file %s already exists. Overwrite?(n)", outfile);
-            if (getchar() != 'y') exit(EXIT_SUCCESS);
+        else if (strcmp(*argv, "-j") == 0 && argc > 1) {
+            argc--; argv++;
+            sscanf(*argv, "%d", &nthread);
         }
-        freopen(outfile, "w", stdout);
-    }
-    fclose(ifp);
-    freopen(infile, "r", stdin);
-}
-/*---------------------------------------------------------------------*/
-void header(void) {
-    char line[MAXCLM], * p;
-    if (read_chk_line(line) == 1) error_exit(5, "1.0-2.0");
-    crinex_version = atoi(line);
-    if ((strncmp(&line[0], "1.0", C3) != 0 && strncmp(&line[0], "3.0", C3) != 0) ||
-        strncmp(&line[60], "CRINEX VERS   / TYPE", C1 * 19) != 0) error_exit(5, "1.0-2.0");
-    if (read_chk_line(line) == 1) error_exit(8, line);
-
-    if (read_chk_line(line) == 1) error_exit(8, line);
-    CHOP_BLANK(line, p);
-    printf("%s\n", line);
-    if (strncmp(&line[60], "RINEX VERSION / TYPE", C1 * 20) != 0 ||
-        (line[5] != '2' && line[5] != '3' && line[5] != '4')) error_exit(15, "2.x, 3.x  or 4.x");
-    rinex_version = atoi(line);
-
-    do {
-        read_chk_line(line);
-        CHOP_BLANK(line, p);
-        printf("%s\n", line);
-        if (strncmp(&line[60], "# / TYPES OF OBSERV", C1 * 19) == 0 && line[5] != ' ') {
-            ntype = atoi(line);                                        /** for RINEX2 **/
+        else if (strcmp(*argv, "-J") == 0 && argc > 1) {
+            argc--; argv++;
+            if (sscanf(*argv, "%d", &nthread_file) != 1 || nthread_file < 1) help = 1;
         }
-        else if (strncmp(&line[60], "SYS / # / OBS TYPES", C1 * 19) == 0) { /** for RINEX3  **/
-            if (line[0] != ' ') ntype_gnss[(unsigned int)line[0]] = atoi(&line[3]);
-            if (ntype_gnss[(unsigned int)line[0]] > MAXTYPE) error_exit(16, line);
+        else if (strcmp(*argv, "-b") == 0 && argc > 1) {
+            argc--; argv++;
+            if (sscanf(*argv, "%d", &mbyte) != 1 || mbyte < 1 || mbyte > 8) help = 1;
+            else block_size = (size_t)mbyte * 1048576;
         }
-    } while (strncmp(&line[60], "END OF HEADER", C1 * 13) != 0);
-}
-/*---------------------------------------------------------------------*/
-void read_clock(char* dline, long* yu, long* yl) {
-    char* p, * s, * p1;
-
-    p = dline;
-
-    if (*p == '\0') {
-        clk_order = -1;
-    }
-    else {
-        if (*(p + 1) == '&') {        /**** for the case of arc initialization ****/
-            sscanf(p, "%d&", &clk_arc_order);
-            if (clk_arc_order > MAX_DIFF_ORDER) error_exit(7, dline);
-            clk_order = -1;
-            p += 2;
+        else if (strcmp(*argv, "-u") == 0) {
+            flush_epoch = 1;
         }
-        p1 = p; if (*p == '-') p1++;
-        s = strchr(p1, '\0');
-        if ((s - p1) < 9) {                /** s-p1 == strlen(p1) ***/
-            *yu = 0;
-            *yl = atol(p);
+        else if (strcmp(*argv, "-p") == 0) {
+            pipeline = 1;
         }
-        else {
-            s -= 8;
-            *yl = atol(s);
-            *s = '\0';
-            *yu = atol(p);
-            if (*yu < 0) *yl = -*yl;
+        else if (strcmp(*argv, "-t") == 0 && argc > 2) {
+            if (parse_time(argv[1], &t_start) != 0 || parse_time(argv[2], &t_end) != 0) help = 1;
+            use_window = 1;
+            argc -= 2; argv += 2;
         }
-    }
-}
-/*---------------------------------------------------------------------*/
-void process_clock(void) {
-    int i, j;
-    /****************************************/
-    /**** recover the clock offset value ****/
-    /****************************************/
-    if (clk_order < clk_arc_order) {
-        clk_order++;
-        for (i = 0, j = 1; i < clk_order; i++, j++) {
-            clk1.u[j] = clk1.u[i] + clk0.u[i];
-            clk1.l[j] = clk1.l[i] + clk0.l[i];
-            clk1.u[j] += clk1.l[j] / 100000000;  /*** to avoid overflow of dy1.l ***/
-            clk1.l[j] %= 100000000;
+        else if (strcmp(*argv, "-G") == 0 && argc > 1) {
+            argc--; argv++;
+            systems = *argv;
         }
-    }
-    else {
-        for (i = 0, j = 1; i < clk_order; i++, j++) {
-            clk1.u[j] = clk1.u[i] + clk0.u[j];
-            clk1.l[j] = clk1.l[i] + clk0.l[j];
-            clk1.u[j] += clk1.l[j] / 100000000;
-            clk1.l[j] %= 100000000;
+        else if (strcmp(*argv, "-P") == 0 && argc > 1) {
+            argc--; argv++;
+            prns = *argv;
         }
-    }
-    /* Signs of py1->u and py1->l can be different at this stage */
-    /*   and will be adjustied before outputting */
-}
-/*---------------------------------------------------------------------*/
-int  put_event_data(char* dline, char* p_event) {
-    /***********************************************************************/
-    /*  - Put event data for one event.                                    */
-    /*  - This function is called when the event flag > 1.                 */
-    /***********************************************************************/
-    int i, n;
-    char* p;
-    do {
-        dline[0] = ep_top_to;
-        CHOP_BLANK(dline, p);
-        printf("%s\n", dline);
-        if (strlen(dline) > 29) {
-            n = atoi((p_event + 1));
-            for (i = 0; i < n; i++) {
-                read_chk_line(dline);
-                CHOP_BLANK(dline, p);
-                printf("%s\n", dline);
-                if (strncmp(&dline[60], "# / TYPES OF OBSERV", C1 * 19) == 0 && dline[5] != ' ') {
-                    ntype = atoi(dline);                                        /** for RINEX2 **/
-                }
-                else if (strncmp(&dline[60], "SYS / # / OBS TYPES", C1 * 19) == 0) { /** for RINEX3 **/
-                    if (dline[0] != ' ') ntype_gnss[(unsigned int)dline[0]] = atoi(&dline[3]);
-                    if (ntype_gnss[(unsigned int)dline[0]] > MAXTYPE) error_exit(16, dline);
-                }
-            }
+        else if (strcmp(*argv, "-O") == 0 && argc > 1) {
+            argc--; argv++;
+            types = *argv;
         }
-
-        do {
-            nl_count++;
-            if (fgets(dline, MAXCLM, stdin) == NULL) exit(exit_status);  /*** eof: exit program successfully ***/
-        } while (crinex_version >= 3 && dline[0] == '&');
-        CHOP_LF(dline, p);
-
-        if (dline[0] != ep_top_from || strlen(dline) < 29 || !isdigit(*p_event)) {
-            if (!skip) error_exit(9, dline);
-            fprintf(stderr, "WARNING :  The epoch should be initialized, but not.\n");
-            return 1;
+        else if (strcmp(*argv, "-h") == 0) {
+            help = 1;
         }
-    } while (*p_event != '0' && *p_event != '1');
-    return 0;
-}
-/*---------------------------------------------------------------------*/
-void skip_to_next(char* dline) {
-    char* p;
-    exit_status = EXIT_WARNING;
-    fprintf(stderr, "    line %ld : skip until an initialized epoch is found.", nl_count);
-    if (rinex_version == 2) {
-        p = dline + 3;    /** pointer to the space between year and month **/
-    }
-    else {
-        p = dline + 6;
-    }
-
-    do {
-        nl_count++;
-        if (fgets(dline, MAXCLM, stdin) == NULL) {
-            fprintf(stderr, "  .....next epoch not found before EOF.\n");
-            if (rinex_version == 2) {
-                printf("%29d%3d\n%-60sCOMMENT\n", 4, 1, "  *** Some epochs are skipped by CRX2RNX ***");
-            }
-            else {
-                printf(">%31d%3d\n%-60sCOMMENT\n", 4, 1, "  *** Some epochs are skipped by CRX2RNX ***");
-            }
-            exit(exit_status);
+        else {
+            help = 1;
         }
-    } while (dline[0] != ep_top_from || strlen(dline) < 29 || *p != ' '
-        || *(p + 3) != ' ' || *(p + 6) != ' ' || *(p + 9) != ' '
-        || *(p + 12) != ' ' || *(p + 23) != ' ' || *(p + 24) != ' '
-        || !isdigit(*(p + 25)));
-
-    CHOP_LF(dline, p);
-    fprintf(stderr, "  .....next epoch found at line %ld.\n", nl_count);
-    if (rinex_version == 2) {
-        printf("%29d%3d\n%-60sCOMMENT\n", 4, 1, "  *** Some epochs are skipped by CRX2RNX ***");
-    }
-    else {
-        printf(">%31d%3d\n%-60sCOMMENT\n", 4, 1, "  *** Some epochs are skipped by CRX2RNX ***");
     }
 
+    if ((systems != NULL || prns != NULL) && crx_decoder().set_filter(systems, prns) != 0) help = 1;
+    if (types != NULL && crx_decoder().set_types(types) != 0) help = 1;
+    if (help == 1 || (nfout == 1 && infiles.size() > 1)) error_exit(1, progname);
 }
 /*---------------------------------------------------------------------*/
-void set_sat_table(char* p_new, char* p_old, int nsat1, int* sattbl) {
-    /***********************************************************************/
-    /*  - Read number of satellites (nsat)                                 */
-    /*  - Compare the satellite list at the epoch (*p_new) and that at the */
-    /*    previous epoch(*p_old), and make index (*sattbl) for the         */
-    /*    corresponding order of the satellites.                           */
-    /*    *sattbl is set to -1 for new satellites.                         */
-    /***********************************************************************/
-    int i, j;
-    char* ps;
+void read_list(const char* listfile) {
+    /**** read names of the input files (one file per line) ****/
+    char line[MAXCLM], * p;
+    FILE* fp;
 
-    /*** set # of data types for each satellite ***/
-    if (rinex_version == 2) {             /** for RINEX2 **/
-        for (i = 0; i < nsat; i++) { ntype_record[i] = ntype; }
-    }
-    else {                                /** for RINEX3 **/
-        for (i = 0, ps = p_new; i < nsat; i++, ps += 3) {
-            ntype_record[i] = ntype_gnss[(unsigned int)*ps];  /*** # of data type for the GNSS system ***/
-            if (ntype_record[i] < 0)error_exit(20, p_new);
-        }
-    }
-    for (i = 0; i < nsat; i++, p_new += 3) {
-        *sattbl = -1;
-        for (j = 0, ps = p_old; j < nsat1; j++, ps += 3) {
-            if (strncmp(p_new, ps, C3) == 0) {
-                *sattbl = j;
-                break;
-            }
-        }
-        sattbl++;
+    if ((fp = fopen(listfile, "r")) == NULL) error_exit(4, listfile);
+    while (fgets(line, MAXCLM, fp) != NULL) {
+        if ((p = strchr(line, '\n')) == NULL) error_exit(14, line);
+        while (p > line && isspace((unsigned char)*(p - 1))) p--;   /** chop CR/LF and blank **/
+        *p = '\0';
+        if (line[0] != '\0') infiles.push_back(line);
     }
+    fclose(fp);
 }
 /*---------------------------------------------------------------------*/
-void data(char* p_sat_lst, int* sattbl, char dflag[][MAXTYPE * 2]) {
-    /********************************************************************/
-    /*  Functions                                                       */
-    /*      (1) compose the original data from 3rd order difference     */
-    /*      (2) repair the flags                                        */
-    /*  sattbl : previous column on which the satellites are set        */
-    /*           new satellites are set to -1                           */
-    /*       u : upper X digits of the data                             */
-    /*       l : lower 5 digits of the data                             */
-    /*            ( y = u*100 + l/1000)                                 */
-    /*   date of previous epoch are set to dy0                           */
-    /********************************************************************/
-    data_format* py1, * py0;
-    int  i, j, k, k1, * i0;
+int  set_outfile(size_t n) {
+    /**** check the n-th input file and set the name of the output file. ****/
+    /**** This is done in the main thread because the user may be asked  ****/
+    /**** whether the existing file is overwritten.                      ****/
+    char outfile[MAXCLM], answer[8];
+    const char* infile = infiles[n].c_str();
     char* p;
+    FILE* fp;
 
-    for (i = 0, i0 = sattbl, p = p_sat_lst; i < nsat; i++, i0++, p += 3) {
-        /**** set # of data types for the GNSS type    ****/
-        /**** and write satellite ID in case of RINEX3 ****/
-        /**** ---------------------------------------- ****/
-        if (rinex_version >= 3) {
-            ntype = ntype_record[i];
-            strncpy(p_buff, p, C3);
-            p_buff += 3;
-        }
-        /**** repair the data flags ****/
-        /**** ----------------------****/
-        if (*i0 < 0) {       /* new satellite */
-            if (rinex_version >= 3) {
-                *flag[i] = '\0';
-            }
-            else {
-                sprintf(flag[i], "%-*s", ntype * 2, dflag[i]);
-            }
-        }
-        else {
-            strncpy(flag[i], flag1[*i0], ntype * C2);
-        }
-        repair(flag[i], dflag[i]);
-
-        /**** recover the date, and output ****/
-        /**** ---------------------------- ****/
-        for (j = 0, py1 = dy1[i]; j < ntype; j++, py1++) {
-            if (py1->arc_order >= 0) {
-                py0 = &(dy0[*i0][j]);
-                if (py1->order < py1->arc_order) {
-                    (py1->order)++;
-                    for (k = 0, k1 = 1; k < py1->order; k++, k1++) {
-                        py1->u[k1] = py1->u[k] + py0->u[k];
-                        py1->l[k1] = py1->l[k] + py0->l[k];
-                        py1->u[k1] += py1->l[k1] / 100000;  /*** to avoid overflow of dy1.l ***/
-                        py1->l[k1] %= 100000;
-                    }
-                }
-                else {
-                    for (k = 0, k1 = 1; k < py1->order; k++, k1++) {
-                        py1->u[k1] = py1->u[k] + py0->u[k1];
-                        py1->l[k1] = py1->l[k] + py0->l[k1];
-                        py1->u[k1] += py1->l[k1] / 100000;
-                        py1->l[k1] %= 100000;
-                    }
-                }
-                /* Signs of py1->u and py1->l can be different at this stage */
-                /*   and will be adjusted before outputting                 */
-                putfield(py1, &flag[i][j * 2]);
-            }
-            else {
-                if (crinex_version == 1) {                       /*** CRINEX 1 assumes that flags are always ***/
-                    p_buff += sprintf(p_buff, "                "); /*** blank if data field is blank           ***/
-                    flag[i][j * 2] = flag[i][j * 2 + 1] = ' ';
-                }
-                else {                                            /*** CRINEX 3 evaluate flags independently **/
-                    p_buff += sprintf(p_buff, "              %c%c", flag[i][j * 2], flag[i][j * 2 + 1]);
-                }
-            }
-            if ((j + 1) == ntype || (rinex_version == 2 && (j + 1) % 5 == 0)) {
-                while (*--p_buff == ' ') {}; p_buff++;  /*** cut spaces ***/
-                *p_buff++ = '\n';
-            }
-        }
-    }
-}
-/*---------------------------------------------------------------------*/
-void repair(char* s, char* ds) {
-    for (; *s != '\0' && *ds != '\0'; ds++, s++) {
-        if (*ds == ' ')continue;
-        if (*ds == '&')
-            *s = ' ';
-        else
-            *s = *ds;
-    }
-    if (*ds != '\0') {
-        sprintf(s, "%s", ds);
-        for (; *s != '\0'; s++) {
-            if (*s == '&') *s = ' ';
-        }
+    /************************/
+    /*** check input file ***/
+    /************************/
+    p = strrchr((char*)infile, '.');
+    if (p == NULL || *(p + 4) != '\0'
+        || (toupper(*(p + 3)) != 'D'
+            && strcmp(p + 1, "CRX") != 0
+            && strcmp(p + 1, "crx") != 0)
+        ) {
+        file_error(3, p);
+        return EXIT_FAILURE;
     }
-}
-/*---------------------------------------------------------------------*/
-int  getdiff(data_format* y, data_format* dy0, int i0, char* dflag) {
-    int j, length;
-    char* s, * s1, * s2, line[MAXCLM];
 
-    /******************************************/
-    /****  separate the fields with '\0'   ****/
-    /******************************************/
-    if (read_chk_line(line) != 0) return 1;
-    for (j = 0, s = line; j < ntype; s++) {
-        if (*s == '\0') {
-            j++;
-            *(s + 1) = '\0';
-        }
-        else if (*s == ' ') {
-            j++;
-            *s = '\0';
-        }
+    if ((fp = fopen(infile, "r")) == NULL) {
+        file_error(4, infile);
+        return EXIT_FAILURE;
     }
-    strcpy(dflag, s);
+    fclose(fp);
 
-    /************************************/
-    /*     read the differenced data    */
-    /************************************/
-    s1 = line;
-    for (j = 0; j < ntype; j++, y++, dy0++) {
-        if (*s1 == '\0') {
-            y->arc_order = -1;      /**** arc_order < 0 means that the field is blank ****/
-            y->order = -1;
-            s1++;
-        }
-        else {
-            if (*(s1 + 1) == '&') {     /**** arc initialization ****/
-                y->order = -1;
-                y->arc_order = atoi(s1);
-                s1 += 2;
-                if (y->arc_order > MAX_DIFF_ORDER) error_exit(7, line);
-            }
-            else if (i0 < 0) {
-                if (!skip) error_exit(11, line);
-                fprintf(stderr, "WARNING : New satellite, but data arc is not initialized.\n");
-                return 1;
-            }
-            else if (dy0->arc_order < 0) {
-                if (!skip) error_exit(12, line);
-                fprintf(stderr, "WARNING : New data sequence but without initialization.\n");
-                return 1;
-            }
-            else {
-                y->order = dy0->order;
-                y->arc_order = dy0->arc_order;
-            }
-            length = (s2 = strchr(s1, '\0')) - s1;
-            if (*s1 == '-') length--;
-            if (length < 6) {
-                y->u[0] = 0;
-                y->l[0] = atol(s1);
-            }
-            else {
-                s = s2 - 5;
-                y->l[0] = atol(s); *s = '\0';
-                y->u[0] = atol(s1);
-                if (y->u[0] < 0) y->l[0] = -y->l[0];
+    /*************************/
+    /*** check output file ***/
+    /*************************/
+    if (nfout == 0) {
+        strcpy(outfile, infile);
+        p = strrchr(outfile, '.');
+        if (*(p + 3) == 'd') { *(p + 3) = 'o'; }
+        else if (*(p + 3) == 'D') { *(p + 3) = 'O'; }
+        else if (strcmp(p + 1, "crx") == 0) { strcpy((p + 1), "rnx"); }
+        else if (strcmp(p + 1, "CRX") == 0) { strcpy((p + 1), "RNX"); }
+
+        if ((fp = fopen(outfile, "r")) != NULL) {
+            fclose(fp);
+            if (force == 0) {
+                fprintf(stderr, "The file %s already exists. Overwrite?(n)", outfile);
+                if (fgets(answer, sizeof(answer), stdin) == NULL || answer[0] != 'y') return EXIT_SUCCESS;
             }
-            s1 = s2 + 1;
         }
+        outfiles[n] = outfile;
     }
-    return 0;
+    return EXIT_SUCCESS;
 }
 /*---------------------------------------------------------------------*/
-void putfield(data_format* y, char* flag) {
-    int  i;
-
-    i = y->order;
-
-    if (y->u[i] < 0 && y->l[i]>0) {
-        y->u[i]++; y->l[i] -= 100000;
-    }
-    else if (y->u[i] > 0 && y->l[i] < 0) {
-        y->u[i]--; y->l[i] += 100000;
-    }
-    /* The signs of y->u and y->l are the same (or zero) at this stage */
+int  convert_file(size_t n) {
+    /**** convert the n-th input file (called in a worker thread) ****/
+    crx_decoder* decoder;
+    crx_index index;
+    conv_stats stats;
+    FILE* ifp, * ofp;
+    int rc, normal_end;
+
+    if ((ifp = fopen(infiles[n].c_str(), "r")) == NULL) {
+        file_error(4, infiles[n].c_str());
+        return EXIT_FAILURE;
+    }
+    if (nfout == 1) {
+        ofp = stdout;
+    }
+    else if ((ofp = fopen(outfiles[n].c_str(), "w")) == NULL) {
+        fclose(ifp);
+        file_error(4, outfiles[n].c_str());
+        return EXIT_FAILURE;
+    }
+
+    decoder = new crx_decoder;
+    decoder->skip = skip;
+    decoder->output_overflow = output_overflow;
+    decoder->block_size = block_size;
+    decoder->flush_epoch = flush_epoch;
+    decoder->pipeline = pipeline;
+    decoder->nthread = nthread_file;
+    decoder->set_filter(systems, prns);
+    decoder->set_types(types);
+    decoder->use_window = use_window;
+    decoder->t_start = t_start;
+    decoder->t_end = t_end;
+    if (use_window && index.read(infiles[n].c_str()) == 0) decoder->index = &index;
+    if (show_stats) decoder->stats = &stats;
+    rc = decoder->convert(ifp, ofp);
+    if (rc == EXIT_FAILURE) {
+        std::lock_guard<std::mutex> lock(err_mutex);
+        if (infiles.size() > 1) fprintf(stderr, "%s :\n", infiles[n].c_str());
+        decoder->print_error(stderr);
+    }
+    if (show_stats) report_stats(infiles[n].c_str(), &stats);
+    normal_end = decoder->normal_end;   /*** =0 at EOF while skipping or after event data ***/
+    delete decoder;
 
-    if (y->u[i] != 0) {                                    /* ex) 123.456  -123.456 */
-        p_buff += sprintf(p_buff, "%8ld %5.5ld%c%c", y->u[i], labs(y->l[i]), *flag, *(flag + 1));
-        p_buff[-8] = p_buff[-7];
-        p_buff[-7] = p_buff[-6];
-        if (y->u[i] > 99999999 || y->u[i] < -9999999) {
-            if (output_overflow) {
-                fprintf(stderr, "Warning: line %ld. : Data record becomes out of range allowed in the RINEX format. The output is corrupted.\n", nl_count);
-                exit_status = EXIT_WARNING;
-            }
-            else {
-                error_exit(17, "Data record");
-            }
-        }
-    }
-    else {
-        p_buff += sprintf(p_buff, "         %5.5ld%c%c", labs(y->l[i]), *flag, *(flag + 1));
-        if (p_buff[-7] != '0') {                        /* ex)  12.345    -2.345 */
-            p_buff[-8] = p_buff[-7];
-            p_buff[-7] = p_buff[-6];
-            if (y->l[i] < 0) p_buff[-9] = '-';
-        }
-        else if (p_buff[-6] != '0') {                  /* ex)   1.234    -1.234 */
-            p_buff[-7] = p_buff[-6];
-            p_buff[-8] = (y->l[i] < 0) ? '-' : ' ';
-        }
-        else {                                          /* ex)    .123     -.123 */
-            p_buff[-7] = (y->l[i] < 0) ? '-' : ' ';
-        }
-    }
-    p_buff[-6] = '.';
+    fclose(ifp);
+    if (ofp != stdout) fclose(ofp);
+    if (delete_if_no_error && normal_end && !use_window && systems == NULL && prns == NULL
+        && types == NULL && rc == EXIT_SUCCESS) remove(infiles[n].c_str());
+    return rc;
 }
 /*---------------------------------------------------------------------*/
-void print_clock(long yu, long yl, int shift_clk) {
-    char tmp[8], * p_tmp, * p;
-    int n, sgn;
-
-    if (yu < 0 && yl>0) {
-        yu++; yl -= 100000000;
-    }
-    else if (yu > 0 && yl < 0) {
-        yu--; yl += 100000000;
+void file_error(int error_no, const char* string) {
+    /**** messages for the errors on each file (the conversion of ****/
+    /**** the other files is continued)                           ****/
+    std::lock_guard<std::mutex> lock(err_mutex);
+    if (error_no == 3) {
+        fprintf(stderr, "ERROR : invalid file name  %s\n", string);
+        fprintf(stderr, "The extension of the input file name should be [.??d] or [.crx].\n");
+        fprintf(stderr, "To convert the files whose name is not fit to the above conventions,\n");
+        fprintf(stderr, "use of this program as a filter is also possible. \n");
+        fprintf(stderr, "    for example)  cat file.in | %s - > file.out\n", PROGNAME);
     }
-    /* The signs of yu and yl are the same (or zero) at this stage */
-
-    /** add ond more digit to handle '-0'(RINEX2) or '-0000'(RINEX3) **/
-    sgn = (yl < 0) ? -1 : 1;
-    n = sprintf(tmp, "%.*ld", shift_clk + 1, yu * 10 + sgn); /** AT LEAST fractional parts are filled with 0 **/
-    n--;                           /** n: number of digits excluding the additional digit **/
-    p_tmp = &tmp[n];
-    *p_tmp = '\0';
-    p_tmp -= shift_clk;       /** pointer to the top of last "shift_clk" digits **/
-    p_buff += sprintf(p_buff, "  .%s", p_tmp);  /** print last "shift_clk" digits.  **/
-    if (n > shift_clk) {
-        p_tmp--;
-        p = p_buff - shift_clk - 2;
-        *p = *p_tmp;
-
-        if (n > shift_clk + 1) {
-            *(p - 1) = *(p_tmp - 1);
-            if (n > shift_clk + 2) {
-                if (output_overflow) {
-                    fprintf(stderr, "Warning: line %ld. : Clock offset becomes out of range allowed in the RINEX format. The output is corrupted.\n", nl_count);
-                    exit_status = EXIT_WARNING;
-                }
-                else {
-                    error_exit(17, "Clock offset");
-                }
-            }
-        }
+    if (error_no == 4) {
+        fprintf(stderr, "ERROR : can't open %s\n", string);
     }
-
-    p_buff += sprintf(p_buff, "%8.8ld\n", labs(yl));
 }
 /*---------------------------------------------------------------------*/
-int  read_chk_line(char* line) {
-    char* p;
-
-    nl_count++;
-    if (fgets(line, MAXCLM, stdin) == NULL) error_exit(8, line);
-    if ((p = strchr(line, '\n')) == NULL) {
-        if (fgetc(stdin) == EOF) {     /** check if EOF is there **/
-            error_exit(8, line);
-        }
-        else {
-            if (!skip) error_exit(13, line);
-            return 1;
-        }
-    }
-    if (*(p - 1) == '\n')p--;
-    if (*(p - 1) == '\r')p--;   /*** check DOS CR/LF ***/
-    *p = '\0';
-    return 0;
+void report_stats(const char* name, const conv_stats* stats) {
+    /**** time of the phases and the counts of one file (--stats) ****/
+    std::lock_guard<std::mutex> lock(err_mutex);
+    if (name != NULL) fprintf(stderr, "%s : ", name);
+    fprintf(stderr, "%s statistics\n", PROGNAME);
+    stats->print(stderr, 0);
 }
 /*---------------------------------------------------------------------*/
 void error_exit(int error_no, const char* string) {
     if (error_no == 1) {
-        fprintf(stderr, "Usage: %s [file] [-] [-f] [-s] [-d] [-h]\n", string);
+        fprintf(stderr, "Usage: %s [file ...] [-l list] [-j #] [-J #] [-] [-f] [-s] [-d] [-b #] [-u] [-p] [-t start end] [-G systems] [-P list] [-O types] [--stats] [-h]\n", string);
         fprintf(stderr, "    stdin and stdout are used if input file name is not given.\n");
-        fprintf(stderr, "    -  : output to stdout\n");
+        fprintf(stderr, "    -l list : convert also the files listed in \"list\" (one file per line)\n");
+        fprintf(stderr, "    -j # : number of worker threads when several files are given\n");
+        fprintf(stderr, "           (default: number of CPUs)\n");
+        fprintf(stderr, "    -J # : recover each file in segments by # threads. The segments start at\n");
+        fprintf(stderr, "           the initialized epochs (see -e option of RNX2CRX). Not used with\n");
+        fprintf(stderr, "           -s, -u, -p, -t, or if the input is not a regular file.\n");
+        fprintf(stderr, "    -  : output to stdout (only for one input file)\n");
         fprintf(stderr, "    -f : force overwrite of output file\n");
         fprintf(stderr, "    -s : skip strange epochs (default:stop with error)\n");
         fprintf(stderr, "           This option may be used for salvaging usable data when middle of\n");
@@ -831,96 +420,41 @@ void error_exit(int error_no, const char* string) {
         fprintf(stderr, "                     happens in the lost part of the data.\n");
         fprintf(stderr, "    -d      : delete the input file if conversion finishes without errors\n");
         fprintf(stderr, "              (i.e. exit code = %d or %d).\n", EXIT_SUCCESS, EXIT_WARNING);
-        fprintf(stderr, "              This option does nothing if stdin is used for the input.\n");
+        fprintf(stderr, "              This option does nothing if stdin is used for the input,\n");
+        fprintf(stderr, "              or with -t, -G, -P or -O (the output is only a part of the input).\n");
+        fprintf(stderr, "    -b #    : size of the output block in MB (1-8, default: %d)\n", DEFAULT_BLOCK_SIZE / 1048576);
+        fprintf(stderr, "    -u      : write out the output at every epoch (for real-time use)\n");
+        fprintf(stderr, "    -p      : read, convert and write in separate threads (for large files)\n");
+        fprintf(stderr, "    -t start end : output only the epochs from start to end (yyyy-mm-ddThh:mm:ss).\n");
+        fprintf(stderr, "              If <input file>%s made by \"RNX2CRX -x\" is there, the recovery\n", INDEX_SUFFIX);
+        fprintf(stderr, "              starts from the initialized epoch just before \"start\".\n");
+        fprintf(stderr, "    -G systems : output only the satellites of these GNSS systems (e.g. GE)\n");
+        fprintf(stderr, "    -P list : output only these satellites (e.g. G01,G05,E11)\n");
+        fprintf(stderr, "              With -G or -P, \"# OF SATELLITES\" and \"PRN / # OF OBS\" are\n");
+        fprintf(stderr, "              removed from the header. Blank system of RINEX 2 is GPS.\n");
+        fprintf(stderr, "    -O types : output only these observation types (e.g. C1C,L1C,C2W,L2W, or\n");
+        fprintf(stderr, "              C1,L1,P2,L2 for RINEX 2). The lists of the types in the header\n");
+        fprintf(stderr, "              are rewritten, and the satellites of a system without any of\n");
+        fprintf(stderr, "              them are not output. \"PRN / # OF OBS\" and \"# OF SATELLITES\"\n");
+        fprintf(stderr, "              are removed from the header.\n");
+        fprintf(stderr, "    --stats : print the time of each phase of the conversion (reading,\n");
+        fprintf(stderr, "              parsing, reconstruction, formatting, output), the numbers of\n");
+        fprintf(stderr, "              epochs, satellites, fields, arc initializations and skipped\n");
+        fprintf(stderr, "              epochs, and the output bytes by category\n");
         fprintf(stderr, "    -h : display help message\n\n");
+        fprintf(stderr, "    When several files are given, the exit code of each file is printed\n");
+        fprintf(stderr, "    at the end and the worst one is returned.\n");
         fprintf(stderr, "    exit code = %d (success)\n", EXIT_SUCCESS);
         fprintf(stderr, "              = %d (error)\n", EXIT_FAILURE);
         fprintf(stderr, "              = %d (warning)\n", EXIT_WARNING);
         fprintf(stderr, "    [version : %s]\n", VERSION);
         exit(EXIT_FAILURE);
     }
-    if (error_no == 3) {
-        fprintf(stderr, "ERROR : invalid file name  %s\n", string);
-        fprintf(stderr, "The extension of the input file name should be [.??d] or [.crx].\n");
-        fprintf(stderr, "To convert the files whose name is not fit to the above conventions,\n");
-        fprintf(stderr, "use of this program as a filter is also possible. \n");
-        fprintf(stderr, "    for example)  cat file.in | %s - > file.out\n", PROGNAME);
-        exit(EXIT_FAILURE);
-    }
-    if (error_no == 4) {
-        fprintf(stderr, "ERROR : can't open %s\n", string);
-        exit(EXIT_FAILURE);
-    }
-    if (error_no == 5) {
-        fprintf(stderr, "ERROR : The file format is not Compact RINEX or the version of\n");
-        fprintf(stderr, "        the format is not valid. This software can deal with\n");
-        fprintf(stderr, "        only Compact RINEX format ver.%s.\n", string);
-        exit(EXIT_FAILURE);
-    }
-    if (error_no == 6) {
-        fprintf(stderr, "ERROR at line %ld : exceed maximum number of satellites(%d)\n", nl_count, MAXSAT);
-        fprintf(stderr, "      start>%s<end\n", string);
-        exit(EXIT_FAILURE);
-    }
-    if (error_no == 7) {
-        fprintf(stderr, "ERROR at line %ld : exceed maximum order of difference (%d)\n", nl_count, MAX_DIFF_ORDER);
-        fprintf(stderr, "      start>%s<end\n", string);
-        exit(EXIT_FAILURE);
-    }
-    if (error_no == 8) {
-        fprintf(stderr, "ERROR : The file seems to be truncated in the middle.\n");
-        fprintf(stderr, "        The conversion is interrupted after reading the line %ld :\n", nl_count);
-        fprintf(stderr, "      start>%s<end\n", string);
-        exit(EXIT_FAILURE);
-    }
-    if (error_no == 9) {
-        fprintf(stderr, "ERROR at line %ld : The arc should be initialized, but not.\n", nl_count);
-        fprintf(stderr, "      start>%s<end\n", string);
-        exit(EXIT_FAILURE);
-    }
-    if (error_no == 11) {
-        fprintf(stderr, "ERROR at line %ld : New satellite, but data arc is not initialized.\n", nl_count);
-        fprintf(stderr, "      start>%s<end\n", string);
-        exit(EXIT_FAILURE);
-    }
-    if (error_no == 12) {
-        fprintf(stderr, "ERROR at line %ld : The data field in previous epoch is blank, but the arc is not initialized.\n", nl_count);
-        fprintf(stderr, "      start>%s<end\n", string);
-        exit(EXIT_FAILURE);
-    }
-    if (error_no == 13) {
-        fprintf(stderr, "ERROR at line %ld : null character is found in the line or the line is too long (>%d) at line.\n", nl_count, MAXCLM);
-        fprintf(stderr, "      start>%s<end\n", string);
-        exit(EXIT_FAILURE);
-    }
     if (error_no == 14) {
-        fprintf(stderr, "ERROR at line %ld. : Length of file name exceed MAXCLM(%d).\n", nl_count, MAXCLM);
+        fprintf(stderr, "ERROR at line %ld. : Length of file name exceed MAXCLM(%d).\n", 0L, MAXCLM);
         fprintf(stderr, "     start>%s<end\n", string);
         exit(EXIT_FAILURE);
     }
-    if (error_no == 15) {
-        fprintf(stderr, "ERROR : The format version of the original RINEX file is not valid.\n");
-        fprintf(stderr, "         This software can deal with only (compressed) RINEX format ver.%s.\n", string);
-        exit(EXIT_FAILURE);
-    }
-    if (error_no == 16) {
-        fprintf(stderr, "ERROR at line %ld. : Number of data types exceed MAXTYPE(%d).\n", nl_count, MAXTYPE);
-        fprintf(stderr, "     start>%s<end\n", string);
-        exit(EXIT_FAILURE);
-    }
-    if (error_no == 17) {
-        fprintf(stderr, "ERROR at line %ld. : %s becomes out of range allowed in the RINEX format.\n", nl_count, string);
-        exit(EXIT_FAILURE);
-    }
-    if (error_no == 20) {
-        fprintf(stderr, "ERROR at line %ld. : A GNSS type not defined in the header is found.\n", nl_count);
-        fprintf(stderr, "     start>%s<end\n", string);
-        exit(EXIT_FAILURE);
-    }
-
-}
-/*---------------------------------------------------------------------*/
-void no_error_exit() {
-    if (delete_if_no_error && exit_status != 2 && n_infile == 1)  remove(infile);
-    exit(exit_status);
+    file_error(error_no, string);
+    exit(EXIT_FAILURE);
 }
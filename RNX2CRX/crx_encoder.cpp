@@ -0,0 +1,1273 @@
+/***************************************************************************
+ * 飺 RNX ʽѹ㷨ʵ֣crx_encoder ࣩ
+ * ; ԭ main.cpp  main()data()ggetline()take_diff()putdiff()
+ *        ѹ̣״̬ΪԱֵͨ
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "crx_encoder.h"
+#include "../common/f14_field.h"
+#include "../common/int_text.h"
+#include "../common/str_diff.h"
+
+/***************************************************************************
+* 飺ڴ
+* ;ÿѭһѭ
+*       FLUSH_BUFF 飩
+*       CLEAR_BUFF ֱ
+****************************************************************************/
+#define FLUSH_BUFF put_epoch(), *(p_buff = top_buff)='\0'
+#define CLEAR_BUFF *(p_buff = top_buff) = '\0'
+#define PUT_ARC_INIT p_buff = put_long(p_buff, ARC_ORDER), *p_buff++ = '&', *p_buff = '\0'   /* sprintf(p_buff, "%d&", ARC_ORDER) */
+
+/*---------------------------------------------------------------------*/
+crx_encoder::crx_encoder() {
+    ep_reset = 0;
+    skip_strange_epoch = 0;
+    err_no = 0;
+    use_mmap = 1;
+    block_size = DEFAULT_BLOCK_SIZE;
+    flush_epoch = 0;
+    pipeline = 0;
+    index = NULL;
+    nthread = 0;
+    chunk_size = 0;
+    nchunk = 0;
+    penalty = 0;
+    out_bytes = 0;
+    follow = 0;
+    marker = NULL;
+    use_end = 0;
+    end_reached = 0;
+    verify = 0;
+    stats = NULL;
+    bank = 0;
+    dy0 = dy1 = NULL;
+    st0 = st1 = NULL;
+    flag0 = flag = NULL;
+    out_buff = top_buff = p_buff = NULL;
+    out_size = 0;
+}
+/*---------------------------------------------------------------------*/
+crx_encoder::~crx_encoder() {
+    free(out_buff);
+}
+/***************************************************************************
+* 飺ѹ
+* ;ʼ״̬루ӳʱӳļȻ
+*       compress()ÿεö³ʼͬһѹļ
+*       nthread > 1 ӳʱ compress_parallel() ֿ鲢ѹ
+*       -s-u-x-T ʱԪѹ
+*       follow > 0 ʱ벻ӳ䣬ļĩβÿ follow ٶ
+*       ÿԪѹд line_reader::follow()
+*       verify = 1 ʱͬʱ crx_verifier ָȽϣͬʱ
+*        EXIT_FAILUREerr_no = 23ȽҪӳ룬 -p ʱ
+*       Ҳọ̈߳벻ӳʱֻ档
+*       stats != NULL ʱ¼׶εʱ䡢Ԫȵĸ͸ֽ
+*       --stats conv_stats.h
+****************************************************************************/
+int crx_encoder::convert(FILE* in, FILE* out) {
+    int rc;
+
+    init_state();
+    nchunk = 0;
+    penalty = 0;
+    end_reached = 0;
+    reader.follow(follow, marker);
+    reader.open(in, use_mmap, pipeline && !verify);
+    writer.open(out, block_size, pipeline);
+    if (stats != NULL) stats->start();
+    if (verify) {
+        if (reader.mapped() && checker.start(reader.map_data(), reader.map_length()) == 0) {
+            writer.tee(crx_verifier::feed, &checker);
+        }
+        else {
+            fprintf(stderr, "WARNING: the output is not verified, as the input is not a regular file read from the top.\n");
+        }
+    }
+    if (index != NULL) {
+        index->entry.clear();
+        writer.count_lines();
+    }
+    if (nthread > 1 && reader.mapped() && !skip_strange_epoch && !flush_epoch && index == NULL && !use_end) {
+        rc = compress_parallel();
+    }
+    else {
+        rc = compress();
+    }
+    if (index != NULL) {
+        index->size = writer.tell();
+#ifdef _WIN32
+        index->size += writer.lines();  /** "\n" is written as "\r\n" **/
+#endif
+    }
+    out_bytes = writer.tell();
+    if (stats != NULL) stats->enter(PHASE_OUTPUT);
+    writer.close();
+    if (stats != NULL) stats->stop(out_bytes);
+    if (checker.finish(end_reached || rc == EXIT_FAILURE) != 0 && rc != EXIT_FAILURE) {
+        err_no = 23;
+        rc = EXIT_FAILURE;
+    }
+    else if (verify && !reader.mapped() && rc == EXIT_SUCCESS) {
+        rc = EXIT_WARNING;
+    }
+    reader.close();
+    return rc;
+}
+/***************************************************************************
+* 飺ʼ״̬
+* ;һļ -J һֿ飩ʼʱ״̬ݻζʼ
+****************************************************************************/
+void crx_encoder::init_state(void) {
+    ep_count = 0;
+    nl_count = 0;
+    ntype = 0;
+    ntype_max = 0;
+    clk_order = -1;
+    exit_status = EXIT_SUCCESS;
+    err_no = 0;
+    memset(&clk0, 0, sizeof(clk0));
+    memset(&clk1, 0, sizeof(clk1));
+    clk_u = clk_l = 0;
+    strcpy(oldline, "&");
+    nsat_old = 0;
+    g_image[0] = '\0';
+    index_closed = 0;
+    bound = NULL;
+    nbound = next_bound = 0;
+    stopped = 0;
+    null_at_end = 0;
+    chunk_epochs = 0;
+    chunk_first = 0;
+    if (use_end) key_end = time_key(&t_end);
+}
+/***************************************************************************
+* 飺ѹ
+* ;ԭ main ѭ
+****************************************************************************/
+int crx_encoder::compress(void) {
+    int i;
+
+    for (i = 0; i < UCHAR_MAX; i++) ntype_gnss[i] = -1;  /** -1 unless GNSS type is defined **/
+    if (header() != 0) return EXIT_FAILURE;
+    if (follow > 0) writer.flush();
+    return epochs();
+}
+/***************************************************************************
+* 飺Ԫѭ
+* ;ԪѹļĩβΪ -J һֿʱbound != NULL
+*       һԪǡǺĳֿʱֹͣstopped = 1
+*        t_end ʱѹ t_end ԪΪֹt_end ֮Ԫѹ
+*       end_reached = 1
+****************************************************************************/
+int crx_encoder::epochs(void) {
+    char dummy[2] = { '\0','\0' };
+    char* p, * p_event, * p_nsat, * p_satlst, * p_satold, * p_clock, * p_mark = NULL;
+    int sattbl[MAXSAT], i, shift_clk, rc, resync = 0;
+    epoch_time t;
+    double key;
+    /* sattbl[i]: order (at the previous epoch) of i-th satellite */
+    /* (at the current epoch). -1 is set for the new satellites   */
+
+    if (reserve_epoch(NSAT_INIT) != 0) { error(22, ""); return EXIT_FAILURE; }
+    if (rinex_version == 2) {
+        p_event = &newline[28];  /** pointer to event flag **/
+        p_nsat = &newline[29];  /** pointer to n_sat **/
+        p_satlst = &newline[32];  /** pointer to satellite list **/
+        p_satold = &oldline[32];  /** pointer to n_sat of the previous epoch **/
+        p_clock = &newline[68];  /** pointer to clock offset data **/
+        shift_clk = 1;
+    }
+    else {
+        p_event = &newline[31];
+        p_nsat = &newline[32];
+        p_satlst = &newline[41];
+        p_satold = &oldline[41];
+        p_clock = &newline[41];
+        shift_clk = 4;
+    }
+
+    for (CLEAR_BUFF;; FLUSH_BUFF) {
+        if (end_reached) return exit_status;    /** the epoch at t_end is output **/
+        if (bound != NULL) {
+            if (chunk_epochs++ == ARC_ORDER) chunk_first = writer.tell();   /** end of the first ARC_ORDER epochs **/
+            if (nbound > 0 && at_bound()) {        /*** the next chunk starts here ***/
+                stopped = 1;
+                return exit_status;
+            }
+        }
+    SKIP:
+        if (stats != NULL) stats->enter(PHASE_READ);
+        rc = get_next_epoch(newline);
+        if (rc < 0) return EXIT_FAILURE;
+        if (rc == 0) return exit_status;
+        if (stats != NULL) {    /** (rc = 2 : skipped to this epoch, counted once with the data line) **/
+            stats->enter(PHASE_PARSE);
+            stats->skipped += (rc == 2 && !resync);
+            resync = 0;
+        }
+
+        /*** if event flag > 1, then (1)output event data  */
+        /*** (2)initialize all data arcs, and continue to next epoch ***/
+        if (atoi(strncpy(dummy, p_event, C1)) > 1) {
+            if (stats != NULL) stats->enter(PHASE_OTHER);
+            if (put_event_data(newline) != 0) return EXIT_FAILURE;
+            initialize_all(oldline, &nsat_old, 0);
+            continue;
+        }
+        if (use_end && read_epoch_time(newline, &t) == 0) {
+            key = time_key(&t);
+            if (key > key_end) {                   /** after t_end: not compressed **/
+                end_reached = 1;
+                return exit_status;
+            }
+            end_reached = (key == key_end);
+        }
+
+        if (ep_reset > 0 && ++ep_count > ep_reset) initialize_all(oldline, &nsat_old, 1);
+
+        if (strchr(newline, '\0') > p_clock) {
+            if (read_clock(p_clock, shift_clk) != 0) return EXIT_FAILURE;  /**** read clock offset ****/
+        }
+        else {
+            clk_order = -1;                       /*** reset data arc for clock offset ***/
+        }
+
+        nsat = atoi(p_nsat);
+        if (nsat > MAXSAT) { error(8, newline); return EXIT_FAILURE; }
+        if (reserve_epoch(nsat) != 0) { error(22, newline); return EXIT_FAILURE; }
+        if (nsat > 12 && rinex_version == 2) {    /*** read continuation lines ***/
+            if (stats != NULL) stats->enter(PHASE_READ);
+            if (read_more_sat(nsat, p_satlst) < 0) return EXIT_FAILURE;
+            if (stats != NULL) stats->enter(PHASE_PARSE);
+        }
+
+        /**** get observation ****/
+        for (i = 0, p = p_satlst; i < nsat; i++, p += 3) {
+            if ((rc = ggetline(st1[i], dy1[i * NPLANE], flag[i], p, &ntype_record[i])) != 0) {
+                if (rc < 0) return EXIT_FAILURE;
+                CLEAR_BUFF;
+                exit_status = EXIT_WARNING;
+                if (stats != NULL) stats->skipped++;
+                resync = 1;
+                goto SKIP;
+            }
+        }
+        *p = '\0';    /*** terminate satellite list ***/
+
+        if ((rc = set_sat_table(p_satlst, p_satold, nsat_old, sattbl)) != 0) {
+            if (rc < 0) return EXIT_FAILURE;
+            CLEAR_BUFF;
+            exit_status = EXIT_WARNING;
+            if (stats != NULL) stats->skipped++;
+            continue;
+        }
+
+        /***********************************************************/
+        /**** print change of the line & clock offset difference ****/
+        /**** and data difference                               ****/
+        /***********************************************************/
+        if (index != NULL && oldline[0] == '&') put_index(newline);
+        if (stats != NULL) { stats->enter(PHASE_FORMAT); p_mark = p_buff; }
+        p_buff = str_diff(oldline, newline, p_buff);
+        if (stats != NULL) { stats->bytes[BYTES_EPOCH] += (size_t)(p_buff - p_mark); p_mark = p_buff; }
+        if (clk_order > -1) {
+            if (clk_order > 0) process_clock();            /**** process clock offset ****/
+            put_clock(clk1.y[clk_order], clk_order);
+        }
+        else {
+            *p_buff++ = '\n';
+        }
+        if (stats != NULL) stats->bytes[BYTES_CLOCK] += (size_t)(p_buff - p_mark);
+        data(sattbl); *p_buff = '\0';
+        if (stats != NULL) { stats->epochs++; stats->sats += nsat; }
+        /**************************************/
+        /**** save current epoch to buffer ****/
+        /**************************************/
+        nsat_old = nsat;
+        sprintf(oldline, "%s", newline);
+        clk0 = clk1;
+        swap_epoch();
+    }
+}
+/*---------------------------------------------------------------------*/
+int  crx_encoder::header(void) {
+    char line[MAXCLM], line2[41], timestring[20];
+    time_t tc = time(NULL);
+    struct tm tm_buf, * tp = &tm_buf;
+
+    /**** (the thread-safe forms: headers are read in several threads) ****/
+#ifdef _WIN32
+    if (gmtime_s(tp, &tc) != 0) localtime_s(tp, &tc);
+#else
+    if (gmtime_r(&tc, tp) == NULL) localtime_r(&tc, tp);
+#endif
+    strftime(timestring, C1 * 20, "%d-%b-%y %H:%M", tp);
+
+    /*** Check RINEX VERSION / TYPE ***/
+    if (read_chk_line(line) < 0) return -1;
+    if (strncmp(&line[60], "RINEX VERSION / TYPE", C1 * 20) != 0 ||
+        strncmp(&line[20], "O", C1) != 0) return error(15, line);
+
+    rinex_version = atoi(line);
+    if (rinex_version == 2) { writer.print("%-20.20s", CRX_VERSION1); }
+    else if (rinex_version == 3 || rinex_version == 4) { writer.print("%-20.20s", CRX_VERSION2); }
+    else { return error(15, line); }
+    writer.print("%-40.40s%-20.20s\n", "COMPACT RINEX FORMAT", "CRINEX VERS   / TYPE");
+
+    sprintf(line2, "%s %s", PROGNAME, VERSION);
+    writer.print("%-40.40s%-20.20sCRINEX PROG / DATE\n", line2, timestring);
+    writer.print("%s\n", line);
+    do {
+        if (read_chk_line(line) < 0) return -1;
+        writer.print("%s\n", line);
+        if (strncmp(&line[60], "# / TYPES OF OBSERV", C1 * 19) == 0 && line[5] != ' ') {
+            ntype = atoi(line);                                        /** for RINEX2 **/
+            if (ntype > MAXTYPE) return error(16, line);
+            if (ntype > ntype_max) ntype_max = ntype;
+        }
+        else if (strncmp(&line[60], "SYS / # / OBS TYPES", C1 * 19) == 0) { /** for RINEX3 **/
+            if (line[0] != ' ') ntype_gnss[(unsigned int)line[0]] = atoi(&line[3]);
+            if (ntype_gnss[(unsigned int)line[0]] > MAXTYPE) return error(16, line);
+            if (ntype_gnss[(unsigned int)line[0]] > ntype_max) ntype_max = ntype_gnss[(unsigned int)line[0]];
+        }
+    } while (strncmp(&line[60], "END OF HEADER", C1 * 13) != 0);
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+int  crx_encoder::get_next_epoch(char* p_line) {
+    /**** find next epoch line.                                                          ****/
+    /**** If the line seems to be abnormal, print warning message                        ****/
+    /**** and skip until next epoch is found                                             ****/
+    /**** return value  0 : end of the file                                              ****/
+    /****               1 : normal end                                                   ****/
+    /****               2 : trouble in the line                                          ****/
+    /****              -1 : error (see err_no)                                           ****/
+    const char* p_in, * q;
+    char* p;
+    size_t len;
+
+    nl_count++;
+    if ((p_in = reader.next(MAXCLM, &len)) == NULL) return 0;  /*** EOF: exit program successfully ***/
+    memcpy(p_line, p_in, len);
+    p_line[len] = '\0';
+
+    if ((q = find_newline(p_in, len)) == NULL) {
+        if (*p_line == '\032') return 0;              /** DOS EOF **/
+        if (*p_line != '\0' || reader.eof() == 0) {
+            if (!skip_strange_epoch) return error(12, p_line);
+            if (skip_to_next(p_line) < 0) return -1;
+            return 2;
+        }
+        if (bound != NULL) null_at_end = 1;    /** printed by compress_parallel() **/
+        else fprintf(stderr, "WARNING: null characters are detected at the end of file --> neglected.\n");
+        exit_status = EXIT_WARNING;
+        return 0;
+    }
+    p = p_line + (q - p_in);
+    if (p > p_line && *(p - 1) == '\r') { *(--p) = '\0'; };                   /*** remove DOS CR/LF ***/
+    if (p > p_line) { while (*--p == ' ' && p > p_line) {}; p++; } *p = '\0';         /*** chop blank ***/
+
+    if (rinex_version == 2) {
+        if (strlen(p_line) < 29 || *p_line != ' '
+            || *(p_line + 27) != ' ' || !isdigit(*(p_line + 28))
+            || (*(p_line + 29) != ' ' && !isdigit(*(p_line + 29)) && *(p_line + 29) != '\0')) {
+            /**** ------- something strange is found in the epoch line ****/
+            if (!skip_strange_epoch) return error(6, p_line);
+            if (*(p_line + 18) != '.')  CLEAR_BUFF;
+            if (skip_to_next(p_line) < 0) return -1;
+            return 2;
+        }
+    }
+    else {    /* rinex_version == 3 or 4 */
+        if (*p_line != '>') {
+            if (!skip_strange_epoch) return error(6, p_line);
+            CLEAR_BUFF;
+            if (skip_to_next(p_line) < 0) return -1;
+            return 2;
+        }
+        while (p < (p_line + 41)) *p++ = ' '; /*** pad blank ***/
+        *p = '\0';
+    }
+    return 1;
+}
+/*---------------------------------------------------------------------*/
+int  crx_encoder::skip_to_next(char* p_line) {
+    fprintf(stderr, " WARNING at line %ld: strange format. skip to next epoch.\n", nl_count);
+    exit_status = EXIT_WARNING;
+
+    if (rinex_version == 2) {
+        do {                               /**** try to find next epoch line ****/
+            if (read_chk_line(p_line) < 0) return -1;
+        } while (strlen(p_line) < 29 || *p_line != ' ' || *(p_line + 3) != ' '
+            || *(p_line + 6) != ' ' || *(p_line + 9) != ' '
+            || *(p_line + 12) != ' ' || *(p_line + 15) != ' '
+            || *(p_line + 26) != ' ' || *(p_line + 27) != ' '
+            || !isdigit(*(p_line + 28)) || !isspace(*(p_line + 29))
+            || (strlen(p_line) > 68 && *(p_line + 70) != '.'));
+    }
+    else {    /*** for RINEX3 ***/
+        do {
+            if (read_chk_line(p_line) < 0) return -1;
+        } while (*p_line != '>');
+    }
+    initialize_all(oldline, &nsat_old, 0);             /**** initialize all data ***/
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+void crx_encoder::initialize_all(char* oldline, int* nsat_old, int count) {
+    strcpy(oldline, "&");        /**** initialize the epoch data arc ****/
+    clk_order = -1;             /**** initialize the clock data arc ****/
+    *nsat_old = 0;              /**** initialize the all satellite arcs ****/
+    ep_count = count;
+}
+/***************************************************************************
+* 飺浱ǰԪ
+* ;ԭÿԪʱ dy1flag Ƶ dy0flag0ֻ
+*       ָ룬ǰԪΪһԪʱ۲ֵ޹ء
+****************************************************************************/
+void crx_encoder::swap_epoch(void) {
+    bank ^= 1;
+    dy1 = dy_bank[bank].row; dy0 = dy_bank[bank ^ 1].row;
+    st1 = st_bank[bank].row; st0 = st_bank[bank ^ 1].row;
+    flag = flag_bank[bank].row; flag0 = flag_bank[bank ^ 1].row;
+}
+/***************************************************************************
+* 飺ݱ
+* ;ݱΪͷļĹ۲ֵntype_maxΪ n 
+*       ֵΪ n*NPLANE Уʱеݱout_buff Ҳ֮
+*       ԭ̶ʹ MAXSAT*MAXTYPE 顣 0ɹ-1ڴ治㡣
+****************************************************************************/
+int  crx_encoder::reserve_epoch(int n) {
+    size_t size, used;
+    char* p;
+    int k;
+
+    if (out_buff != NULL && n <= st_bank[0].rows() && ntype_max <= st_bank[0].cols()) return 0;
+    for (k = 0; k < 2; k++) {
+        if (st_bank[k].reserve(n, ntype_max) != 0) return -1;
+        if (dy_bank[k].reserve(st_bank[k].rows() * NPLANE, ntype_max) != 0) return -1;
+        if (flag_bank[k].reserve(n, ntype_max * 2 + 1) != 0) return -1;
+    }
+    dy1 = dy_bank[bank].row; dy0 = dy_bank[bank ^ 1].row;
+    st1 = st_bank[bank].row; st0 = st_bank[bank ^ 1].row;
+    flag = flag_bank[bank].row; flag0 = flag_bank[bank ^ 1].row;
+
+    /**** 'x', epoch line, clock and (up to 25 characters per field) the data ****/
+    size = 1 + MAXEPL + 64 + (size_t)st_bank[0].rows() * ((size_t)st_bank[0].cols() * 25 + 4);
+    if (size > out_size) {
+        used = (out_buff != NULL) ? (size_t)(p_buff - top_buff) : 0;
+        if ((p = (char*)realloc(out_buff, size)) == NULL) return -1;
+        out_buff = p;
+        out_size = size;
+        out_buff[0] = 'x';
+        top_buff = &out_buff[1];
+        p_buff = top_buff + used;
+        if (used == 0) *p_buff = '\0';
+    }
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+int  crx_encoder::put_event_data(char* p_line) {
+    /**** This routine is called when event flag >1 is set.  ****/
+    /****      read # of event information lines and output  ****/
+    int i, n;
+    char* p;
+
+    if (rinex_version == 2) {
+        if (*(p_line + 26) == '.') return error(6, p_line);
+        writer.print("&%s\n", (p_line + 1));
+        if (strlen(p_line) > 29) {
+            n = atoi((p_line + 29));     /** n: number of lines to follow **/
+            for (i = 0; i < n; i++) {
+                if (read_chk_line(p_line) < 0) return -1;
+                writer.print("%s\n", p_line);
+                if (strncmp((p_line + 60), "# / TYPES OF OBSERV", C1 * 19) == 0 && *(p_line + 5) != ' ') {
+                    *flag[0] = '\0';
+                    index_closed = 1;
+                    nbound = 0;     //ķֿ鰴ͷļеĹ۲ֵѹֿѹļĩβ
+                    ntype = atoi(p_line);
+                    if (ntype > MAXTYPE) return error(16, p_line);
+                    if (ntype > ntype_max) ntype_max = ntype;
+                }
+            }
+        }
+    }
+    else {
+        if (strlen(p_line) < 35 || *(p_line + 29) == '.') return error(6, p_line);
+        /* chop blanks that were padded in get_next_epoch */
+        p = strchr(p_line + 35, '\0'); while (*--p == ' ') {}; *++p = '\0';
+        writer.print("%s\n", p_line);
+        n = atoi((p_line + 32));         /** n: number of lines to follow **/
+        for (i = 0; i < n; i++) {
+            if (read_chk_line(p_line) < 0) return -1;
+            writer.print("%s\n", p_line);
+            if (strncmp((p_line + 60), "SYS / # / OBS TYPES", C1 * 19) == 0 && *p_line != ' ') {
+                *flag[0] = '\0';
+                index_closed = 1;
+                nbound = 0;
+                ntype_gnss[(unsigned int)*p_line] = atoi((p_line + 3));
+                if (ntype_gnss[(unsigned int)*p_line] > MAXTYPE) return error(16, p_line);
+                if (ntype_gnss[(unsigned int)*p_line] > ntype_max) ntype_max = ntype_gnss[(unsigned int)*p_line];
+            }
+        }
+    }
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+int  crx_encoder::read_clock(char* p_clock, int shift_clk) {
+    /****  read the clock offset value ****/
+    /**  *p_clock : pointer to beginning of clock data **/
+    char* p_dot;      /** pointer for decimal point **/
+    p_dot = p_clock + 2;
+    if (*p_dot != '.') return error(7, p_clock);
+
+    strncpy(p_dot, p_dot + 1, C1 * shift_clk);  /**** shift digits because of too  ****/
+    *(p_dot + shift_clk) = '.';             /**** many digits for fractional part ****/
+    sscanf(p_clock, "%ld.%ld", &clk_u, &clk_l);
+    if (*p_clock == '-' || *(p_clock + 1) == '-') clk_l = -clk_l;
+    if (clk_u > CLOCK_UPPER_MAX || clk_u < -CLOCK_UPPER_MAX
+        || clk_l > CLOCK_LOWER_MAX || clk_l < -CLOCK_LOWER_MAX) return error(7, p_clock);  /** too many digits **/
+    clk1.y[0] = (fixed_t)clk_u * 100000000 + clk_l;
+    if (clk_order < ARC_ORDER) clk_order++;
+    *p_clock = '\0';
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+void crx_encoder::process_clock(void) {
+    int i;
+    for (i = 0; i < clk_order; i++) {
+        clk1.y[i + 1] = clk1.y[i] - clk0.y[i];
+    }
+}
+/*---------------------------------------------------------------------*/
+int  crx_encoder::set_sat_table(char* p_new, char* p_old, int nsat_old, int* sattbl) {
+    /**** sattbl : order of the satellites in the previous epoch   ****/
+    /**** if *sattbl is set to  -1, the data arc for the satellite ****/
+    /**** will be initialized                                      ****/
+    int i, j;
+    char* ps;
+
+    if (sat_new.set(p_new, nsat) == 0 && sat_old.set(p_old, nsat_old) == 0) {
+        /**** all satellites are indexed: no comparison of the lists ****/
+        for (i = 0; i < nsat; i++, p_new += 3) {
+            *sattbl++ = sat_old.find(p_new);
+            if (i == sat_new.first_duplicate()) {
+                if (!skip_strange_epoch) return error(13, p_new);
+                fprintf(stderr, "WARNING:Duplicated satellite in one epoch at line %ld. ... skip\n", nl_count);
+                return 1;
+            }
+        }
+        return 0;
+    }
+    /**** otherwise compare the lists ****/
+    for (i = 0; i < nsat; i++, p_new += 3) {
+        *sattbl = -1;
+        ps = p_old;
+        for (j = 0; j < nsat_old; j++, ps += 3) {
+            if (strncmp(p_new, ps, C3) == 0) {
+                *sattbl = j;
+                break;
+            }
+        }
+        /*** check double entry ***/
+        for (j = i + 1, ps = p_new + 3; j < nsat; j++, ps += 3) {
+            if (strncmp(p_new, ps, C3) == 0) {
+                if (!skip_strange_epoch) return error(13, p_new);
+                fprintf(stderr, "WARNING:Duplicated satellite in one epoch at line %ld. ... skip\n", nl_count);
+                return 1;
+            }
+        }
+        sattbl++;
+    }
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+int  crx_encoder::read_more_sat(int n, char* p) {
+    /**** read continuation line of satellite list (for RINEX2) ****/
+    char line[MAXCLM];
+    int rc;
+
+    do {
+        p += 36;
+        if ((rc = read_chk_line(line)) != 0) return rc;
+        /**** append satellite table ****/
+        if (line[2] == ' ') {
+            sprintf(p, "%s", &line[32]);
+        }
+        else {                        /*** for the files before clarification of format ***/
+            sprintf(p, "%s", &line[0]); /*** by W.Gurtner (IGS mail #1577)                ***/
+        }
+        n -= 12;
+    } while (n > 12);
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+void crx_encoder::data(int* sattbl) {
+    /********************************************************************/
+    /*  Function : output the 3rd order difference of data              */
+    /*       u : upper X digits of the data                             */
+    /*       l : lower 5 digits of the data                             */
+    /*            ( y = u*100 + l/1000 )                                */
+    /*   py->u : upper digits of the 3rd order difference of the data   */
+    /*   py->l : lower digits of the 3rd order difference of the data   */
+    /*  The differences of all the data types of a satellite are taken  */
+    /*  at once (arc_diff()), then each field is checked one by one.    */
+    /*  With stats, the checks of the fields are counted in the time of */
+    /*  formatting, as they are made together with putdiff().          */
+    /********************************************************************/
+    data_format* ps1, * ps0;
+    fixed_t** y1, ** y0;
+    int  i, j, * i0;
+    char* p, * p_mark = NULL;
+
+    for (i = 0, i0 = sattbl; i < nsat; i++, i0++) {
+        if (stats != NULL) stats->enter(PHASE_ARC);
+        y1 = &dy1[i * NPLANE];
+        if (*i0 >= 0) {
+            y0 = &dy0[*i0 * NPLANE];
+            ps0 = st0[*i0];
+            arc_diff(y1, y0, ARC_ORDER, ntype_record[i]);
+        }
+        else {
+            y0 = NULL;
+            ps0 = NULL;
+        }
+        if (stats != NULL) {
+            stats->enter(PHASE_FORMAT);
+            for (j = 0; j < ntype_record[i]; j++) stats->fields += (st1[i][j].order >= 0);
+            p_mark = p_buff;
+        }
+        for (j = 0, ps1 = st1[i]; j < ntype_record[i]; j++, ps1++) {
+            if (ps1->order >= 0) {       /*** if the numerical data field is non-blank ***/
+                if (*i0 < 0 || ps0[j].order == -1) {
+                    /**** initialize the data arc ****/
+                    ps1->order = 0; PUT_ARC_INIT;
+                    if (stats != NULL) stats->arc_inits++;
+                }
+                else {
+                    take_diff(ps1, &ps0[j]);
+                    if (large_slip(y1, y0, j, ps1)) {
+                        /**** initialization of the arc for large cycle slip  ****/
+                        ps1->order = 0; PUT_ARC_INIT;
+                        if (stats != NULL) stats->slips++;
+                    }
+                }
+                putdiff(y1[ps1->order][j]);
+            }
+            else if (*i0 >= 0 && rinex_version == 2) {
+                /**** CRINEX1 (RINEX2) initialize flags for blank field, not put '&' ****/
+                flag0[*i0][j * 2] = flag0[*i0][j * 2 + 1] = ' ';
+            }
+            if (j < ntype_record[i] - 1) *p_buff++ = ' ';   /** ' ' :field separator **/
+        }
+        *(p_buff++) = ' ';  /* write field separator */
+        if (stats != NULL) { stats->bytes[BYTES_DATA] += (size_t)(p_buff - p_mark); p_mark = p_buff; }
+        if (*i0 < 0) {             /* if new satellite initialize all LLI & SN flags */
+            if (rinex_version == 2) {
+                p_buff = str_diff("", flag[i], p_buff);
+            }
+            else {          /*  replace space with '&' for CRINEX3(RINEX3)  */
+                for (p = flag[i]; *p != '\0'; p++) *p_buff++ = (*p == ' ') ? '&' : *p;
+                *p_buff++ = '\n'; *p_buff = '\0';
+            }
+        }
+        else {
+            p_buff = str_diff(flag0[*i0], flag[i], p_buff);
+        }
+        if (stats != NULL) stats->bytes[BYTES_FLAGS] += (size_t)(p_buff - p_mark);
+    }
+}
+/*---------------------------------------------------------------------*/
+int  crx_encoder::ggetline(data_format* ps1, fixed_t* y1, char* flag, char* sat_id, int* ntype_rec) {
+    /**** read data line for one satellite and       ****/
+    /**** set data difference and flags to variables ****/
+    /**** The line is parsed directly in the input.   ****/
+    /**** Fields in the form of F14.3 are converted   ****/
+    /**** by f14_scan(), others by read_value().      ****/
+    char field[16], text[MAXCLM], c0;
+    const char* q;
+    size_t k, k0, n;
+    int i, j, nfield, max_field, rc, kind;
+
+    if (stats != NULL) stats->enter(PHASE_READ);
+    if ((rc = read_chk_view()) != 0) return rc;
+    if (stats != NULL) stats->enter(PHASE_PARSE);
+    if (rinex_version == 2) {             /** for RINEX2 **/
+        max_field = 5;                             /** maximum data types in one line **/
+        *ntype_rec = ntype;                        /** # of data types for the satellite **/
+        k0 = 0;                                    /** start of the first record **/
+    }
+    else {                                /** for RINEX3 **/
+        for (k = 0; k < 3; k++) sat_id[k] = (k < g_len) ? g_line[k] : '\0';  /** put satellite ID to the list of satellites **/
+        c0 = (g_len > 0) ? g_line[0] : '\0';
+        max_field = *ntype_rec = ntype_gnss[(unsigned int)c0];  /*** # of data types for the GNSS system ***/
+        if (max_field < 0) {
+            if (!skip_strange_epoch) return error(21, g_line, g_len);
+            fprintf(stderr, "WARNING at line %ld. : GNSS type '%c' is not defined in the header. ... skip\n", nl_count, (unsigned int)c0);
+            line_image(g_image, 0);
+            return 1;
+        }
+        k0 = 3;
+    }
+    for (i = 0; i < *ntype_rec; i += max_field) {                 /* for each line */
+        nfield = (*ntype_rec - i < max_field ? *ntype_rec - i : max_field); /*** expected # of data fields in the line ***/
+        g_pmax = k0 + 16 * nfield;
+
+        /*** Fields beyond the end of the line are blank. Detect error if there is ***/
+        /*** any character after the position g_pmax (one character is allowed)   ***/
+        if (g_len > g_pmax + 1) {
+            if (!skip_strange_epoch) {
+                line_image(text, 0);
+                return error(9, text);
+            }
+            fprintf(stderr, "WARNING: mismatch of number of the data types at line %ld. ... skip\n", nl_count);
+            line_image(g_image, 0);
+            return 1;
+        }
+
+        /*** parse the line (read value into y1) ***/
+        for (j = 0, k = k0; j < nfield; j++, k += 16, ps1++, y1++) {
+            if (k + 16 <= g_len) {
+                q = g_line + k;
+            }
+            else {
+                n = (k < g_len) ? g_len - k : 0;
+                memcpy(field, g_line + k, n);
+                memset(field + n, ' ', 16 - n);
+                q = field;
+            }
+            kind = f14_scan(q, y1);
+            if (q[10] == '.') {
+                *flag++ = q[14];
+                *flag++ = q[15];
+                if (kind == F14_VALUE) {
+                    ps1->split = 0;
+                }
+                else {          /*** not in the form of F14.3 ***/
+                    if (q != field) memcpy(field, q, 14);
+                    field[14] = '\0';
+                    read_value(field, y1, ps1);
+                }
+                ps1->order = 0;
+                if (g_valued < 0) g_valued = (long)k;
+            }
+            else if (kind == F14_BLANK) {
+                if (rinex_version == 2 && strncmp((q + 14), "  ", C2) != 0) {
+                    line_image(text, 0);
+                    return error(20, text);
+                }
+                *flag++ = q[14];
+                *flag++ = q[15];
+                ps1->order = -1;
+            }
+            else {
+                line_image(text, k);
+                if (!skip_strange_epoch) return error(10, text);
+                fprintf(stderr, "WARNING: abnormal data field at line %ld....skip\n", nl_count);
+                line_image(g_image, 0);
+                return 1;
+            }
+        }
+        line_image(g_image, 0);
+        if (i + max_field < *ntype_rec) {
+            if (stats != NULL) stats->enter(PHASE_READ);
+            if ((rc = read_chk_view()) != 0) return rc;   /* read continuation line */
+            if (stats != NULL) stats->enter(PHASE_PARSE);
+        }
+    }
+    *flag = '\0';
+    return 0;
+}
+/***************************************************************************
+* 飺ؽԭл
+* ;ԭ ggetline() ло͵زո񡢸дֵֶΣϢļض
+*       ʱϢǸдĻ from ʼ '\0' Ϊֹ
+*        g_line/g_len/g_raw/g_pmax/g_valued ַͬ
+****************************************************************************/
+void crx_encoder::line_image(char* dst, size_t from) const {
+    char* p = dst;
+    size_t i, n, v = 0;
+    int padded = (g_pmax != (size_t)-1 && g_len < g_pmax);
+
+    if (g_pmax == (size_t)-1) n = g_len;    /** not yet checked **/
+    else if (padded) n = g_pmax;            /** padded with spaces up to g_pmax **/
+    else n = g_raw;                         /** '\0' at g_len was replaced by ' ' **/
+    if (g_valued >= 0 && from <= (v = (size_t)g_valued) + 14) n = v + 14;  /** '\0' set after the first value **/
+    if (n > MAXCLM - 1) n = MAXCLM - 1;
+
+    for (i = from; i < n; i++) {
+        if (i < g_len) *p++ = g_line[i];
+        else if (padded || i == g_len) *p++ = ' ';
+        else *p++ = g_line[i];
+    }
+    *p = '\0';
+
+    if (g_valued >= 0 && from <= v) {       /** shift of digits in read_value() **/
+        p = dst + (v - from);
+        p[10] = p[9];
+        p[9] = p[8];
+        if (p[7] != ' ' && p[7] != '-') p[8] = '.';
+    }
+}
+/*---------------------------------------------------------------------*/
+void crx_encoder::read_value(char* p, fixed_t* y, data_format* ps) {
+    /**** divide the data into lower 5 digits and upper digits     ****/
+    /**** input p :  pointer to one record (14 characters + '\0')  ****/
+    /**** output  *y : the data * 1000                             ****/
+    /****         ps->split : upper digits - *y / 100000           ****/
+
+    char* p7, * p8, * p9;
+    long u, l;
+    p7 = p + 7;
+    p8 = p7 + 1;
+    p9 = p8 + 1;
+
+    *(p9 + 1) = *p9;            /* shift two digits: ex. 123.456 -> 1223456,  -.345 ->   -345 */
+    *p9 = *p8;                /*                       -12.345 -> -112345, -1.234 -> --1234 */
+    l = atol(p9);             /*                         0.123 ->  . 0123, -0.123 -> --0123 */
+
+    if (*p7 == ' ') {
+        u = 0;
+    }
+    else if (*p7 == '-') {
+        u = 0;
+        l = -l;
+    }
+    else {
+        *p8 = '.';
+        u = atol(p);
+        if (u < 0) l = -l;
+    }
+    *y = (fixed_t)u * 100000 + l;
+    /*** the signs differ only if the field is not in the form of F14.3 ***/
+    ps->split = (u > 0 && l < 0) ? 1 : (u < 0 && l > 0) ? 2 : 0;
+}
+/*---------------------------------------------------------------------*/
+void crx_encoder::take_diff(data_format* ps1, const data_format* ps0) {
+    /**** order of the difference of a continued arc. The differences  ****/
+    /**** themselves have been taken by arc_diff() in data().          ****/
+    ps1->order = ps0->order;
+    if (ps1->order < ARC_ORDER) (ps1->order)++;
+    ps1->split = (unsigned char)((ps1->split & 3) | (ps0->split << 2));
+}
+/*---------------------------------------------------------------------*/
+int  crx_encoder::large_slip(fixed_t* const* y1, fixed_t* const* y0, int j, const data_format* ps1) const {
+    /**********************************************************************/
+    /*  Test of the original program for a large cycle slip:              */
+    /*      |k-th difference of the upper digits| > 100000  (k: order)    */
+    /*  The upper digits u and lower digits l of each value satisfy       */
+    /*  y = u*100000 + l, |l| < 100000, so the k-th difference of l is    */
+    /*  less than 2^k * 100000. The test is therefore decided by y alone  */
+    /*  unless |dy| is close to 100000*100000, in which case u of the     */
+    /*  last k+1 epochs is recovered from the differences of y0.          */
+    /**********************************************************************/
+    fixed_t dy, ay, margin, y, yk[ARC_ORDER + 1], du;
+    long c;
+    int  k, m, i, corr;
+
+    k = ps1->order;
+    dy = y1[k][j];
+    ay = (dy < 0) ? -dy : dy;
+    margin = (fixed_t)99999 << k;
+    if (ay + margin < (fixed_t)100001 * 100000) return 0;
+    if (ay - margin > (fixed_t)100000 * 100000) return 1;
+
+    /**** y at the epochs t, t-1, ..., t-k ****/
+    yk[0] = y1[0][j];
+    for (m = 1; m <= k; m++) {
+        for (i = 0, c = 1, y = 0; i < m; i++) {   /** c : binomial coefficient (m-1, i) **/
+            y += (i % 2 == 0) ? c * y0[i][j] : -c * y0[i][j];
+            c = c * (m - 1 - i) / (i + 1);
+        }
+        yk[m] = y;
+    }
+    /**** k-th difference of the upper digits ****/
+    for (m = 0, c = 1, du = 0; m <= k; m++) {      /** c : binomial coefficient (k, m) **/
+        corr = (ps1->split >> (m * 2)) & 3;
+        y = yk[m] / 100000 + ((corr == 1) ? 1 : (corr == 2) ? -1 : 0);
+        du += (m % 2 == 0) ? c * y : -c * y;
+        c = c * (k - m) / (m + 1);
+    }
+    return du > 100000 || du < -100000;
+}
+/*---------------------------------------------------------------------*/
+void crx_encoder::putdiff(fixed_t dy) {
+    p_buff = put_llong(p_buff, dy);
+}
+/*---------------------------------------------------------------------*/
+void crx_encoder::put_clock(fixed_t dy, int c_order) {
+    /***********************************/
+    /****  output clock diff. data  ****/
+    /***********************************/
+    if (c_order == 0) PUT_ARC_INIT;
+    p_buff = put_llong(p_buff, dy);
+    *p_buff++ = '\n'; *p_buff = '\0';
+}
+/*---------------------------------------------------------------------*/
+int  crx_encoder::read_chk_line(char* line) {
+    const char* p_in, * q;
+    char* p;
+    size_t len;
+    /***************************************/
+    /* Read and check one line.            */
+    /* The end of the line should be '\n'. */
+    /* return value  0 : normal end        */
+    /*               1 : skip (warning)    */
+    /*              -1 : error             */
+    /***************************************/
+    nl_count++;
+    if ((p_in = reader.next(MAXCLM, &len)) == NULL) return error(11, line);
+    memcpy(line, p_in, len);
+    line[len] = '\0';
+    if ((q = find_newline(p_in, len)) == NULL) {
+        if (reader.get_char() == EOF) {
+            return error(11, line);
+        }
+        else {
+            if (!skip_strange_epoch) return error(12, line);
+            fprintf(stderr, "WARNING: null character is found or the line is too long (>%d) at line %ld.\n", MAXCLM, nl_count);
+            return 1;
+        }
+    }
+    p = line + (q - p_in);
+    if (p > line && *(p - 1) == '\r')p--;   /*** check DOS CR/LF ***/
+    if (p > line) { while (*--p == ' ' && p > line) {}; p++; } *p = '\0';   /** Chop blank **/
+    return 0;
+}
+/***************************************************************************
+* 飺һУƣ
+* ; read_chk_line() ͬļ飬иƵ
+*       g_line ֱָ룬g_len Ϊȥ CR/LF βոĳ
+****************************************************************************/
+int  crx_encoder::read_chk_view(void) {
+    const char* q;
+
+    nl_count++;
+    if ((g_line = reader.next(MAXCLM, &g_raw)) == NULL) return error(11, g_image);
+    g_pmax = (size_t)-1;
+    g_valued = -1;
+    if ((q = find_newline(g_line, g_raw)) == NULL) {
+        if (reader.get_char() == EOF) {
+            return error(11, g_line, g_raw);
+        }
+        else {
+            if (!skip_strange_epoch) return error(12, g_line, g_raw);
+            fprintf(stderr, "WARNING: null character is found or the line is too long (>%d) at line %ld.\n", MAXCLM, nl_count);
+            g_len = strnlen(g_line, g_raw);
+            line_image(g_image, 0);
+            return 1;
+        }
+    }
+    if (q > g_line && *(q - 1) == '\r') q--;   /*** check DOS CR/LF ***/
+    if (q > g_line) {
+        while (*--q == ' ' && q > g_line) {}; q++;   /** Chop blank **/
+    }
+    g_len = (size_t)(q - g_line);
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+void crx_encoder::put_epoch(void) {
+    /**** pass the text of the epoch to the output block ****/
+    if (stats != NULL) stats->enter(PHASE_OUTPUT);
+    writer.write(top_buff, (size_t)(p_buff - top_buff));
+    if (flush_epoch || follow > 0) writer.flush();
+}
+/***************************************************************************
+* 飺
+* ;ݻѳʼԪǰݾѽ writerѹļ
+*       еֽλáкźʱCRX2RNX ԴӸԪʼָ
+****************************************************************************/
+void crx_encoder::put_index(const char* p_line) {
+    epoch_time t;
+    unsigned long long offset;
+    long line;
+
+    if (index_closed || read_epoch_time(p_line, &t) != 0) return;
+    offset = writer.tell();
+    line = writer.lines() + 1;
+#ifdef _WIN32
+    offset += line - 1;         /** "\n" is written as "\r\n" **/
+#endif
+    index->add(offset, line, &t);
+}
+/*---------------------------------------------------------------------*/
+int  crx_encoder::error(int error_no, const char* string) {
+    /**** record the error for print_error() and return -1 to the caller ****/
+    err_no = error_no;
+    err_line = nl_count;
+    strncpy(err_string, string, C1 * (MAXCLM - 1));
+    err_string[MAXCLM - 1] = '\0';
+    return -1;
+}
+/*---------------------------------------------------------------------*/
+int  crx_encoder::error(int error_no, const char* string, size_t len) {
+    /**** same as above for a line that is not terminated by '\0' ****/
+    const char* p;
+
+    if ((p = (const char*)memchr(string, '\0', len)) != NULL) len = (size_t)(p - string);
+    if (len > MAXCLM - 1) len = MAXCLM - 1;
+    err_no = error_no;
+    err_line = nl_count;
+    memcpy(err_string, string, len);
+    err_string[len] = '\0';
+    return -1;
+}
+/*---------------------------------------------------------------------*/
+void crx_encoder::print_error(FILE* fp) const {
+    const char* string = err_string;
+
+    if (err_no == 6) {
+        fprintf(fp, "ERROR when reading line %ld.\n", err_line);
+        fprintf(fp, "     start>%s<end\n", string);
+    }
+    if (err_no == 7) {
+        fprintf(fp, "ERROR at line %ld: invalid format for clock offset.\n", err_line);
+        fprintf(fp, "     start>%s<end\n", string);
+    }
+    if (err_no == 8) {
+        fprintf(fp, "ERROR at line %ld : number of satellites exceed the maximum(%d).\n", err_line, MAXSAT);
+        fprintf(fp, "     start>%s<end\n", string);
+    }
+    if (err_no == 9) {
+        fprintf(fp, "ERROR at line %ld : mismatch of number of the data types.\n", err_line);
+        fprintf(fp, "     start>%s<end\n", string);
+    }
+    if (err_no == 10) {
+        fprintf(fp, "ERROR at line %ld : abnormal data field.\n", err_line);
+        fprintf(fp, "     start>%s<end\n", string);
+    }
+    if (err_no == 11) {
+        fprintf(fp, "ERROR : The RINEX file seems to be truncated in the middle.\n");
+        fprintf(fp, "        The conversion is interrupted after reading line %ld :\n", err_line);
+        fprintf(fp, "        start>%s<end\n", string);
+    }
+    if (err_no == 12) {
+        fprintf(fp, "ERROR at line %ld. : null character is found or the line is too long (>%d).\n", err_line, MAXCLM);
+        fprintf(fp, "     start>%s<end\n", string);
+    }
+    if (err_no == 13) {
+        fprintf(fp, "ERROR at line %ld. : Duplicated satellite in one epoch.\n", err_line);
+        fprintf(fp, "     start>%s<end\n", string);
+    }
+    if (err_no == 15) {
+        fprintf(fp, "The first line is :\n%s\n\n", string);
+        fprintf(fp, "ERROR : The file format is not valid. This program is applicable\n");
+        fprintf(fp, "        only to RINEX Version 2/3/4 Observation file.\n");
+    }
+    if (err_no == 16) {
+        fprintf(fp, "ERROR at line %ld. : Number of data types exceed MAXTYPE(%d).\n", err_line, MAXTYPE);
+        fprintf(fp, "     start>%s<end\n", string);
+    }
+    if (err_no == 20) {
+        fprintf(fp, "ERROR at line %ld. : data is blank but there is flag.\n", err_line);
+        fprintf(fp, "     start>%s<end\n", string);
+    }
+    if (err_no == 21) {
+        fprintf(fp, "ERROR at line %ld. : GNSS type '%c' is not defined in the header.\n", err_line, (unsigned int)string[0]);
+        fprintf(fp, "     start>%s<end\n", string);
+    }
+    if (err_no == 22) {
+        fprintf(fp, "ERROR at line %ld. : memory for the data of the epoch can not be allocated.\n", err_line);
+        fprintf(fp, "     start>%s<end\n", string);
+    }
+    if (err_no == 23) checker.print_error(fp);
+}
+/***************************************************************************
+* 飺ֿж
+* ;һǡǺĳֿʱ 1
+****************************************************************************/
+int  crx_encoder::at_bound(void) {
+    unsigned long long pos = reader.tell();
+
+    while (next_bound < nbound && bound[next_bound] < pos) next_bound++;
+    return next_bound < nbound && bound[next_bound] == pos;
+}
+/***************************************************************************
+* 飺Ԫж
+* ;p[0...n-1]з¼־Ϊ 0  1 Ԫʱ 1
+*       RINEX2 ļ skip_to_next() ͬ
+****************************************************************************/
+static int epoch_line(const char* p, size_t n, int rinex_version) {
+    if (n > 0 && p[n - 1] == '\r') n--;
+    if (rinex_version == 2) {
+        if (n < 32 || p[0] != ' ' || p[3] != ' ' || p[6] != ' ' || p[9] != ' ' || p[12] != ' '
+            || p[15] != ' ' || p[26] != ' ' || p[27] != ' ' || p[29] != ' ') return 0;
+        if (n > 70 && p[70] != '.') return 0;
+        return p[28] == '0' || p[28] == '1';
+    }
+    return n >= 35 && p[0] == '>' && (p[31] == '0' || p[31] == '1');
+}
+/***************************************************************************
+* 飺ҷֿ
+* ; from ֮󣨺 from еһ𣩵һԪеλã
+*       Ҳʱ size
+****************************************************************************/
+static size_t find_epoch(const char* map, size_t size, size_t from, int rinex_version) {
+    const char* p, * e, * end = map + size;
+
+    if (from == 0 || from >= size) return size;
+    p = map + from;
+    if (p[-1] != '\n') {                /** go to the top of the next line **/
+        if ((p = (const char*)memchr(p, '\n', (size_t)(end - p))) == NULL) return size;
+        p++;
+    }
+    for (; p < end; p = e + 1) {
+        if ((e = (const char*)memchr(p, '\n', (size_t)(end - p))) == NULL) break;
+        if (epoch_line(p, (size_t)(e - p), rinex_version)) return (size_t)(p - map);
+    }
+    return size;
+}
+/***************************************************************************
+* 飺ѹһֿ
+* ; b[0] Ԫʼݻγʼѹ outֱһǡ
+*       b[1] ... b[nb-1] еĳֿ㣨ļĩβ۲ֵʹͷļ룬
+*       ͷļ out
+****************************************************************************/
+int  crx_encoder::encode_chunk(const char* map, size_t size, const unsigned long long* b, int nb, std::string* out) {
+    unsigned long long head;
+    int i, rc;
+
+    init_state();
+    reader.open_memory(map, size);
+    writer.open_memory(out, MIN_BLOCK_SIZE);
+    if (stats != NULL) stats->start();
+    for (i = 0; i < UCHAR_MAX; i++) ntype_gnss[i] = -1;
+    if (header() != 0) {
+        rc = EXIT_FAILURE;
+    }
+    else {
+        writer.flush();
+        out->clear();
+        head = writer.tell();
+        reader.seek(b[0]);
+        nl_count = 0;
+        bound = b + 1;
+        nbound = nb - 1;
+        rc = epochs();
+        chunk_bytes = writer.tell() - head;
+        chunk_first = (chunk_epochs > ARC_ORDER) ? chunk_first - head : chunk_bytes;
+    }
+    if (stats != NULL) stats->stop(writer.tell());
+    writer.close();
+    reader.close();
+    return rc;
+}
+/***************************************************************************
+* 飺ֿ鲢ѹ
+* ;ӳļԼÿ chunk_size ֽһԪΪֿ㣬 nthread
+*       ̷ֱ߳ѹֿ飬ÿֿ鿪ʼʱݻζʼ
+*       κΰ汾 CRX2RNX ָܻ Compact RINEX
+*       һֿѹһǡǺĳֿΪֹȷ˸
+*       ȷʵԪУķֿ飨ֻǿԪУ۲ֵ
+*       ¼ı󣬸÷ֿѹļĩβֿ˳дͬʱ
+*        2*nthread ֿ顣
+*       ʼʹļֽֿǰ ARC_ORDER Ԫֽ
+*       ߣ֮Ԫƽ֮ƣ penalty
+****************************************************************************/
+int  crx_encoder::compress_parallel(void) {
+    std::vector<unsigned long long> b;
+    std::vector<crx_encoder*> part;
+    std::vector<std::string> text;
+    std::vector<int> rcs;
+    std::vector<std::thread> workers;
+    std::vector<conv_stats> part_stats;
+    std::unique_ptr<std::atomic<int>[]> done;
+    std::atomic<int> next(0), consumed(0), cancel(0);
+    std::string last_image;         //һֿУļضʱĴϢ
+    const char* map = reader.map_data();
+    size_t size = reader.map_length(), seg, t;
+    long base_line, n_other;
+    int i, k, m, n, nseg, rc = EXIT_SUCCESS;
+
+    for (i = 0; i < UCHAR_MAX; i++) ntype_gnss[i] = -1;
+    if (header() != 0) return EXIT_FAILURE;
+
+    /**** start of the chunks ****/
+    b.push_back(reader.tell());
+    seg = chunk_size;
+    if (seg == 0) {
+        seg = (size_t)(size - b[0]) / ((size_t)nthread * 4);
+        if (seg < CHUNK_MIN_SIZE) seg = CHUNK_MIN_SIZE;
+        if (seg > CHUNK_MAX_SIZE) seg = CHUNK_MAX_SIZE;
+    }
+    while ((t = find_epoch(map, size, (size_t)b.back() + seg, rinex_version)) < size) b.push_back(t);
+    nseg = (int)b.size();
+    if (nseg < 2) return epochs();
+
+    part.assign(nseg, NULL);
+    text.resize(nseg);
+    rcs.assign(nseg, EXIT_SUCCESS);
+    if (stats != NULL) part_stats.resize(nseg);
+    done.reset(new std::atomic<int>[nseg]);
+    for (k = 0; k < nseg; k++) done[k] = 0;
+
+    for (i = 0; i < nthread && i < nseg; i++) {
+        workers.emplace_back([&]() {
+            int j, w;
+            while ((j = next++) < nseg) {
+                for (w = 0; j >= consumed + 2 * nthread && !cancel; w++) ring_wait(w);
+                if (!cancel) {
+                    part[j] = new crx_encoder;
+                    part[j]->ep_reset = ep_reset;
+                    part[j]->block_size = block_size;
+                    part[j]->stats = (stats != NULL) ? &part_stats[j] : NULL;
+                    rcs[j] = part[j]->encode_chunk(map, size, &b[j], nseg - j, &text[j]);
+                }
+                done[j].store(1, std::memory_order_release);
+            }
+        });
+    }
+
+    /**** output the chunks in order ****/
+    base_line = nl_count;
+    for (k = 0; k < nseg; k = m) {
+        for (i = 0; !done[k].load(std::memory_order_acquire); i++) ring_wait(i);
+        if (stats != NULL) stats->enter(PHASE_OUTPUT);
+        writer.write(text[k].data(), text[k].size());
+        if (stats != NULL) {
+            stats->enter(PHASE_OTHER);
+            stats->add(part_stats[k]);
+        }
+        if (rcs[k] == EXIT_FAILURE) {
+            err_no = part[k]->err_no;
+            err_line = part[k]->err_line + base_line;
+            strcpy(err_string, part[k]->err_string);
+            if (err_no == 11 && err_string[0] == '\0') strcpy(err_string, last_image.c_str());
+            rc = EXIT_FAILURE;
+            break;
+        }
+        if (rcs[k] == EXIT_WARNING) rc = EXIT_WARNING;
+        if (part[k]->null_at_end) fprintf(stderr, "WARNING: null characters are detected at the end of file --> neglected.\n");
+        nchunk++;
+        if (k > 0 && (n_other = part[k]->chunk_epochs - 1 - ARC_ORDER) > 0) {
+            penalty += (long long)part[k]->chunk_first
+                - (long long)((part[k]->chunk_bytes - part[k]->chunk_first) * ARC_ORDER / n_other);
+        }
+        base_line += part[k]->nl_count;
+        last_image = part[k]->g_image;
+        m = part[k]->stopped ? k + 1 + part[k]->next_bound : nseg;
+        for (i = k; i < m; i++) {       /** (k+1 ... m-1 : discarded) **/
+            for (n = 0; !done[i].load(std::memory_order_acquire); n++) ring_wait(n);
+            delete part[i];
+            part[i] = NULL;
+            std::string().swap(text[i]);
+            consumed = i + 1;
+        }
+    }
+    cancel = 1;
+    for (i = 0; i < (int)workers.size(); i++) workers[i].join();
+    for (k = 0; k < nseg; k++) delete part[k];
+    return rc;
+}
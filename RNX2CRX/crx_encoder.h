@@ -0,0 +1,234 @@
+/***************************************************************************
+ * 飺 RNX ʽѹRINEX -> Compact RINEX
+ * ; ԭ main.cpp еȫ״̬ѹ̷װΪ crx_encoder ࣬
+ *        ÿӵж״̬ʱֵͨǵ exit()
+ *        һпͬʱڶ߳ѹļ
+ ****************************************************************************/
+#ifndef CRX_ENCODER_H
+#define CRX_ENCODER_H
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+#include "../common/arc_kernel.h"
+#include "../common/block_writer.h"
+#include "../common/conv_stats.h"
+#include "../common/crx_index.h"
+#include "../common/epoch_table.h"
+#include "../common/fixed_value.h"
+#include "../common/line_reader.h"
+#include "../common/sat_index.h"
+#include "crx_verify.h"
+
+/***************************************************************************
+* 飺汾
+* ;,㷨޹أ
+****************************************************************************/
+
+#define VERSION  "ver.4.1.0"
+
+/***************************************************************************
+* 飺˳
+* ;ʶ˳״̬㷨޹أ
+****************************************************************************/
+#define EXIT_WARNING 2
+
+#ifndef EXIT_FAILURE
+#define EXIT_FAILURE 1
+#endif
+
+#ifndef EXIT_SUCCESS
+#define EXIT_SUCCESS 0
+#endif
+
+/***************************************************************************
+* 飺һЩ궨
+* ;һЩѹ㷨汾šڴ󳤶
+*       汾Ҫ
+*       ڴ󳤶Ҫڴʱȷֵ
+****************************************************************************/
+#define CRX_VERSION1 "1.0"    /* CRINEX version for RINEX 2.x */
+#define CRX_VERSION2 "3.0"    /* CRINEX version for RINEX 3.x */
+#define PROGNAME "RNX2CRX"
+#define MAXSAT    999         /* Maximum number of satellites observed at one epoch (I3) */
+#define MAXTYPE   999         /* Maximum number of data types for a GNSS system */
+#define MAXCLM   2048         /* Maximum columns in one line */
+#define MAXEPL   (MAXCLM + MAXSAT * 3)  /* epoch line with the list of all satellites */
+#define NSAT_INIT  16         /* satellites allocated first (enlarged on demand) */
+#define ARC_ORDER 3           /* order of difference to take    */
+#define CHUNK_MIN_SIZE  (1 << 20)   /* size of the chunks compressed in parallel (-J) */
+#define CHUNK_MAX_SIZE  (16 << 20)  /* when not given by -c */
+
+constexpr size_t C1 = sizeof("");               //һַȣ߿ܿǵַȵӰ죬ַж
+constexpr size_t C2 = sizeof(" ");              //ַ
+constexpr size_t C3 = sizeof("  ");             //ַ
+constexpr size_t C14 = sizeof("             "); //ʮĸַ
+
+/* define data structure for fields of clock offset and observation records */
+/* Those data will be handled as integers after eliminating decimal points.  */
+/* Each value is held in one 64-bit integer (see fixed_value.h).             */
+
+#define CLOCK_UPPER_MAX 999999999L          /* range of the digits of a clock offset */
+#define CLOCK_LOWER_MAX 99999999999999999LL /* that can be held in fixed_t         */
+
+/***************************************************************************
+* 飺ʱʽṹ
+* ;ڴ洢Ӳy[k] Ϊ k ײ֣Ӳȫɵ
+****************************************************************************/
+typedef struct clock_format {
+    fixed_t y[ARC_ORDER + 1];
+} clock_format;
+
+/***************************************************************************
+* 飺ݸʽṹ
+* ;ڴ洢һֶε״̬order Ϊֽ-1հֶΣ
+*       ֲֵţ arc_kernel.h i ĵ k ײ
+*       ۲ֵ*1000Ϊ dy[i * NPLANE + k][j]ͬһǵй۲ֵͿһ֡
+*       жҪԭĸλ֣y/100000Ըʽ淶ֶΣ
+*       read_value() ĸλ y/100000  1split ¼ 4 Ԫ
+*       һֵÿԪ 2 λ large_slip()
+****************************************************************************/
+typedef struct data_format {
+    int  order;
+    unsigned char split;
+} data_format;
+
+#define NPLANE (ARC_ORDER + 1)  /* planes of the differences of one satellite */
+
+/***************************************************************************
+* 飺ѹ
+* ;convert()  in  RINEX ۲ļ out д Compact RINEX
+*        EXIT_SUCCESS / EXIT_WARNING / EXIT_FAILURE
+*        EXIT_FAILURE ʱ print_error() ԭͬĴϢ
+*       ݱͷļеĹ۲ֵͳֹ䣬Ҫ
+****************************************************************************/
+class crx_encoder {
+public:
+    crx_encoder();
+    ~crx_encoder();
+
+    int  convert(FILE* in, FILE* out);
+    void print_error(FILE* fp) const;
+
+    long ep_reset;              /* initialize all arcs at every # epochs (-e) */
+    int  skip_strange_epoch;    /* default : stop with error */
+    int  err_no;                /* error number of the last failure (0: no error) */
+    int  use_mmap;              /* read the input through a memory mapping if possible */
+    size_t block_size;          /* size of the output block (bytes) */
+    int  flush_epoch;           /* write the output at every epoch */
+    int  pipeline;              /* read, convert and write in 3 threads (-p) */
+    crx_index* index;           /* list of the initialized epochs (-x), NULL: not made */
+    int  nthread;               /* compress one mapped file in chunks by # threads (-J #) */
+    size_t chunk_size;          /* size of the chunks (bytes, -c #), 0: from the file size */
+    int  nchunk;                /* number of the chunks output by the last convert() (0: not split) */
+    long long penalty;          /* bytes added by initializing the arcs at the chunks (estimated) */
+    unsigned long long out_bytes;   /* size of the output of the last convert() */
+    int  follow;                /* wait for the epochs written later, polling every # ms (-F #) */
+    const char* marker;         /* with follow, the input ends when this file exists (-R) */
+    int  use_end;               /* stop at the end time t_end (-T) */
+    epoch_time t_end;
+    int  end_reached;           /* =1 if the last convert() stopped at t_end */
+    int  verify;                /* recover the output in memory and compare it with the input (-v) */
+    conv_stats* stats;          /* time of the phases and counts (--stats), NULL: not taken */
+
+private:
+    line_reader reader;         //жȡӳļзָͳȣ
+    block_writer writer;        //飨Ԫкһд
+    crx_verifier checker;       //-vĻضУ
+
+    /***************************************************************************
+    * 飺״̬
+    * ;ԭȫֱΪÿѹУⲿֶıһҪ
+    *       ÿһĺ壬ڶ㷨
+    ****************************************************************************/
+    long ep_count;
+    long nl_count;
+    int rinex_version;          /* =2, 3 or 4 */
+    int nsat, ntype, ntype_gnss[UCHAR_MAX], ntype_record[MAXSAT], clk_order;
+    int ntype_max;              //ͷļ¼Ĺ۲ֵݱ
+    int exit_status;
+
+    clock_format clk1;          //ʱṹڴ洢ʱ
+    long clk_u, clk_l;          //Ӳλ͵λ֣sscanf ʧʱԭֵ
+    clock_format clk0;          //ʱṹڴ洢ʱ
+    epoch_table<fixed_t> dy_bank[2];     //ǰԪһԪֵÿ NPLANE У齻ʹã
+    epoch_table<data_format> st_bank[2]; //ǰԪһԪֶ״̬
+    epoch_table<char> flag_bank[2];      //ǰԪһԪı־
+    int bank;                            //ǰԪõһ
+    fixed_t** dy0, ** dy1;      //dy0һԪdy1ǰԪԪʱָ
+    data_format** st0, ** st1;  // dy0/dy1 ͬ
+    char** flag0, ** flag;      // dy0/dy1 ͬһԪͨ sattbl 
+    char* out_buff;             //Buffer洢飬λΪxλÿ
+    size_t out_size;            //out_buff ĴСݱ
+    char* top_buff, * p_buff;     //λȻΪxʣµλΪɵ
+
+    char newline[MAXEPL];
+    char oldline[MAXEPL];
+    int nsat_old;
+    sat_index sat_new, sat_old; //¾Ԫϵͳĸ PRN ֱӲң
+
+    int index_closed;           //۲ֵѱ¼ı䣬˺Ԫ
+    double key_end;             //t_end  time_key()
+
+    /***************************************************************************
+    * 飺-J ķֿ
+    * ;bound[0...nbound-1] Ϊֿ㣨ֽλãֿѹһ
+    *       ǡ֮һʱֹͣΪͳƳʼӵֽ
+    ****************************************************************************/
+    const unsigned long long* bound;
+    int nbound, next_bound;     //δĵһ
+    int stopped;                //=1 bound[next_bound] ֹͣ
+    int null_at_end;            //=1ļĩβпַ compress_parallel() 
+    long chunk_epochs;          //ԪѭĴ
+    unsigned long long chunk_first, chunk_bytes;    //ǰ ARC_ORDER Ԫֽȫֽ
+
+    long err_line;              /* line number at which the error was detected */
+    char err_string[MAXCLM];    /* copy of the offending text for print_error() */
+
+    /***************************************************************************
+    * 飺ggetline ǰе״̬
+    * ;вٸƵֱнԭʱ
+    *       ͵޸Ĺл¼ؽϢ line_image
+    ****************************************************************************/
+    const char* g_line;         //ǰ
+    size_t g_len, g_raw;        //ȥβոĳȣĳȣз
+    size_t g_pmax;              //һֶεĽλã(size_t)-1δ飩
+    long g_valued;              //һֵֶελã-1ޣ
+    char g_image[MAXCLM];       //һеĻݣļضʱ
+
+    void init_state(void);
+    int  compress(void);
+    int  compress_parallel(void);
+    int  encode_chunk(const char* map, size_t size, const unsigned long long* b, int nb, std::string* out);
+    int  epochs(void);
+    int  at_bound(void);
+    int  header(void);
+    int  get_next_epoch(char* p_line);
+    int  skip_to_next(char* p_line);
+    void initialize_all(char* oldline, int* nsat_old, int count);
+    void swap_epoch(void);
+    int  reserve_epoch(int n);
+    int  put_event_data(char* p_line);
+    int  read_clock(char* line, int shift_cl);
+    void process_clock(void);
+    int  set_sat_table(char* p_new, char* p_old, int nsat_old, int* sattbl);
+    int  read_more_sat(int n, char* p);
+    void data(int* sattbl);
+    int  ggetline(data_format* ps1, fixed_t* y1, char* flag, char* sat_id, int* ntype_rec);
+    void line_image(char* dst, size_t from) const;
+    void read_value(char* p, fixed_t* y, data_format* ps);
+    void take_diff(data_format* ps1, const data_format* ps0);
+    int  large_slip(fixed_t* const* y1, fixed_t* const* y0, int j, const data_format* ps1) const;
+    void putdiff(fixed_t dy);
+    void put_clock(fixed_t dy, int clk_order);
+    int  read_chk_line(char* line);
+    int  read_chk_view(void);
+    void put_epoch(void);
+    void put_index(const char* p_line);
+    int  error(int error_no, const char* string);
+    int  error(int error_no, const char* string, size_t len);
+};
+
+#endif
@@ -0,0 +1,242 @@
+/***************************************************************************
+ * 飺 ѹĻضУ飨crx_verifier ࣩ
+ * ;  CRX2RNX  crx_decoder ڴлָѹȽϡ
+ *        ļֻ crx_decoder.h crx_encoder.h Ķ岻ͬʱ
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "crx_verify.h"
+#include "../CRX2RNX/crx_decoder.h"
+#include "../common/line_reader.h"
+
+#ifdef _WIN32
+#define fdopen   _fdopen
+#define close_fd _close
+#else
+#define close_fd close
+#endif
+
+#define PIPE_SIZE 65536         /* buffer of the pipes (Windows) */
+#define VERIFY_LINE_MAX 65536   /* longest line compared (longer lines are stopped by RNX2CRX) */
+
+/***************************************************************************
+* 飺ܵ
+* ;*rd Ϊˣ*wr Ϊдˣɹ 0ʧܷ -1
+****************************************************************************/
+static int open_pipe(FILE** rd, FILE** wr) {
+    int fd[2];
+
+#ifdef _WIN32
+    if (_pipe(fd, PIPE_SIZE, _O_BINARY) != 0) return -1;
+#else
+    if (pipe(fd) != 0) return -1;
+#endif
+    *rd = fdopen(fd[0], "rb");
+    *wr = fdopen(fd[1], "wb");
+    if (*rd != NULL && *wr != NULL) return 0;
+    if (*rd != NULL) fclose(*rd); else close_fd(fd[0]);
+    if (*wr != NULL) fclose(*wr); else close_fd(fd[1]);
+    *rd = *wr = NULL;
+    return -1;
+}
+/***************************************************************************
+* 飺еıȽϳ
+* ; read_chk_line() ͬȥзCR βոĳ
+****************************************************************************/
+static size_t chop(const char* p, size_t n) {
+    if (n > 0 && p[n - 1] == '\n') n--;
+    if (n > 0 && p[n - 1] == '\r') n--;
+    while (n > 0 && p[n - 1] == ' ') n--;
+    return n;
+}
+/***************************************************************************
+* 飺ֵ
+* ;p[0...m-1] Ϊո񡢸ź 0 ʱ 1 0򷵻 -1
+****************************************************************************/
+static int sign_of(const char* p, size_t m) {
+    size_t i = 0;
+    int neg = 0;
+
+    while (i < m && p[i] == ' ') i++;
+    if (i < m && p[i] == '-') { neg = 1; i++; }
+    while (i < m && p[i] == '0') i++;
+    return (i == m) ? neg : -1;
+}
+/***************************************************************************
+* 飺ֵıȽ
+* ;CRX2RNX  -1  1 ֵ֮Ӳ͹۲ֵʱʡСǰ 0
+*       " 0.123" -> "  .123""-0.123" -> " -.123"ֵΪ 0 ʱ
+*       "-0.000" -> "  .000"ȳֻЩطͬʱ 1
+****************************************************************************/
+static int same_numbers(const char* p, const char* q, size_t n) {
+    size_t i, j, k;
+    int a, b;
+
+    for (i = 0; i < n; i++) {
+        if (p[i] == q[i]) continue;
+        if (i > 0 && p[i] != '-' && p[i - 1] >= '0' && p[i - 1] <= '9') return 0;   /** not a leading 0 **/
+        for (j = i; j < n && j < i + 3 && p[j] != '.'; j++) {}
+        if (j == n || p[j] != '.' || q[j] != '.') return 0;
+        for (k = j + 1; k < n && k <= j + 3 && p[k] == '0'; k++) {}   /** 0 of F14.3 **/
+        a = sign_of(p + i, j - i);
+        b = sign_of(q + i, j - i);
+        if (a < 0 || b < 0 || (a != b && k <= j + 3)) return 0;
+        i = j;
+    }
+    return 1;
+}
+/*---------------------------------------------------------------------*/
+crx_verifier::crx_verifier() {
+    rnx = NULL;
+    rnx_size = 0;
+    decoder = NULL;
+    crx_out = crx_in = rnx_out = rnx_in = NULL;
+    dec_status = EXIT_SUCCESS;
+    diff = 0;
+    diff_line = 0;
+}
+/*---------------------------------------------------------------------*/
+crx_verifier::~crx_verifier() {
+    stop();
+    delete decoder;
+}
+/***************************************************************************
+* 飺ʼУ
+* ;̺ܵ߳ͱȽ̡߳rnx  finish() ֮ǰЧ
+****************************************************************************/
+int  crx_verifier::start(const char* p, size_t size) {
+    stop();
+    delete decoder;
+    decoder = NULL;
+    rnx = p;
+    rnx_size = size;
+    dec_status = EXIT_SUCCESS;
+    diff = 0;
+    diff_line = 0;
+    expected.clear();
+    decoded.clear();
+    if (open_pipe(&crx_in, &crx_out) != 0) return -1;
+    if (open_pipe(&rnx_in, &rnx_out) != 0) {
+        fclose(crx_in);
+        fclose(crx_out);
+        crx_in = crx_out = NULL;
+        return -1;
+    }
+    decoder = new crx_decoder;
+    decoder->block_size = MIN_BLOCK_SIZE;
+    compare_thread = std::thread(&crx_verifier::compare, this);
+    decode_thread = std::thread(&crx_verifier::decode, this);
+    return 0;
+}
+/***************************************************************************
+* 飺ѹ
+* ;block_writer::tee() Ļصѹ߳е
+****************************************************************************/
+void crx_verifier::feed(void* self, const char* p, size_t n) {
+    fwrite(p, 1, n, ((crx_verifier*)self)->crx_out);
+}
+/***************************************************************************
+* 飺У
+* ;رѹĹܵļĩβȴ߳̽
+*       partial=1 ʱ-Tѹָļ̲㲻ͬ
+****************************************************************************/
+int  crx_verifier::finish(int partial) {
+    if (!running()) return 0;
+    stop();
+    if (dec_status == EXIT_FAILURE) return 1;
+    if (diff == 2 && partial) return 0;
+    return diff != 0;
+}
+/*---------------------------------------------------------------------*/
+void crx_verifier::stop(void) {
+    if (!running()) return;
+    fclose(crx_out);
+    crx_out = NULL;
+    decode_thread.join();
+    compare_thread.join();
+    fclose(crx_in);
+    fclose(rnx_in);
+    crx_in = rnx_in = NULL;
+}
+/***************************************************************************
+* 飺߳
+* ;ָѹٶ룬ʣ
+*       ѹдܵʱͣסʱر֪ܵͨȽ߳
+****************************************************************************/
+void crx_verifier::decode(void) {
+    char buff[4096];
+
+    dec_status = decoder->convert(crx_in, rnx_out);
+    while (fread(buff, 1, sizeof(buff), crx_in) > 0) {}
+    fclose(rnx_out);
+    rnx_out = NULL;
+}
+/***************************************************************************
+* 飺Ƚ߳
+* ;бȽϻָ RINEX 루ֵ same_numbers()
+*       ûлзһУDOS EOFַȣѹȽϵ
+*       ǰһΪֹ
+*       ֲͬԶ
+****************************************************************************/
+void crx_verifier::compare(void) {
+    line_reader in, out;
+    const char* p, * q;
+    size_t n, m;
+    long line;
+
+    in.open_memory(rnx, rnx_size);
+    out.open(rnx_in, 0);
+    for (line = 1; (q = out.next(VERIFY_LINE_MAX, &m)) != NULL; line++) {
+        if (diff != 0) continue;
+        p = in.next(VERIFY_LINE_MAX, &n);
+        if (p == NULL || find_newline(p, n) == NULL) {
+            diff = 3;
+            diff_line = line;
+            decoded.assign(q, chop(q, m));
+            continue;
+        }
+        n = chop(p, n);
+        m = chop(q, m);
+        if (n != m || (memcmp(p, q, n) != 0 && !same_numbers(p, q, n))) {
+            diff = 1;
+            diff_line = line;
+            expected.assign(p, n);
+            decoded.assign(q, m);
+        }
+    }
+    if (diff == 0 && (p = in.next(VERIFY_LINE_MAX, &n)) != NULL && find_newline(p, n) != NULL) {
+        diff = 2;
+        diff_line = line;
+        expected.assign(p, chop(p, n));
+    }
+    out.close();
+}
+/*---------------------------------------------------------------------*/
+void crx_verifier::print_error(FILE* fp) const {
+    if (dec_status == EXIT_FAILURE) {
+        fprintf(fp, "ERROR : the output can not be recovered by CRX2RNX.\n");
+        decoder->print_error(fp);
+    }
+    if (diff == 1) {
+        fprintf(fp, "ERROR at line %ld : the recovered RINEX file differs from the input.\n", diff_line);
+        fprintf(fp, "     input     start>%s<end\n", expected.c_str());
+        fprintf(fp, "     recovered start>%s<end\n", decoded.c_str());
+    }
+    if (diff == 2) {
+        fprintf(fp, "ERROR at line %ld : the recovered RINEX file ends before this line of the input.\n", diff_line);
+        fprintf(fp, "     input     start>%s<end\n", expected.c_str());
+    }
+    if (diff == 3) {
+        fprintf(fp, "ERROR at line %ld : the recovered RINEX file is longer than the input.\n", diff_line);
+        fprintf(fp, "     recovered start>%s<end\n", decoded.c_str());
+    }
+}
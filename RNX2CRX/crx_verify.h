@@ -0,0 +1,61 @@
+/***************************************************************************
+ * 飺 ѹĻضУ飨-v
+ * ; ѹ block_writer::tee()ͬһе CRX2RNX
+ *        crx_decoderָ RINEX Ƚϡ
+ *        Ƚϵ read_chk_line() Уȥ CR βո񣩣
+ *        ¼һͬС
+ *        ͱȽϸһ߳нУ̣ܵݣ
+ *        ֻԼһν CPU ʱ䣬ļд
+ *        ӳ䣨ȽʱֱӶӳ룩
+ ****************************************************************************/
+#ifndef CRX_VERIFY_H
+#define CRX_VERIFY_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <string>
+#include <thread>
+
+class crx_decoder;
+
+/***************************************************************************
+* 飺У
+* ;start() ͱȽ̣߳feed() ѹ
+*       finish() ȴ̲߳ؽ
+*       ͬʱ print_error() һͬС
+*       Ƚ߳ڷֲͬԶ߳ڳԶ
+*       ѹκһܵдͣס
+****************************************************************************/
+class crx_verifier {
+public:
+    crx_verifier();
+    ~crx_verifier();
+
+    int  start(const char* rnx, size_t size);   /* rnx[0...size-1] : input. 0 or -1 */
+    int  running(void) const { return crx_out != NULL; }
+    static void feed(void* self, const char* p, size_t n);  /* write_hook of block_writer::tee() */
+    int  finish(int partial);   /* 0 : same, 1 : different. partial=1 : the output may end early */
+    void print_error(FILE* fp) const;
+
+private:
+    const char* rnx;            //루ӳ䣩
+    size_t rnx_size;
+    crx_decoder* decoder;
+    FILE* crx_out, * crx_in;    //ѹ ->  Ĺܵ
+    FILE* rnx_out, * rnx_in;    // -> Ƚ߳ Ĺܵ
+    std::thread decode_thread;
+    std::thread compare_thread;
+    int  dec_status;            //˳
+    int  diff;                  //0ͬ1вͬ2ָļ϶̣3ָļϳ
+    long diff_line;             //һͬУкţ
+    std::string expected, decoded;  //еݣȥ CR βո
+
+    void decode(void);
+    void compare(void);
+    void stop(void);
+
+    crx_verifier(const crx_verifier&) = delete;
+    crx_verifier& operator=(const crx_verifier&) = delete;
+};
+
+#endif
@@ -1,9 +1,19 @@
 /***************************************************************************
  * 飺 RNX ʽѹ㷨ʵ
  * ÷
-          RNX2CRX [file] [-] [-f] [-e # of epochs] [-s] [-d] [-h]
+          RNX2CRX [file ...] [-l list] [-j #] [-J #] [-c #] [-] [-f] [-e # of epochs] [-s] [-d] [-b #] [-u] [-p] [-x]
+                  [-F #] [-R file] [-T end] [-v] [--stats] [-h]
             stdin and stdout are used if input file name is not given.
-            -       : output to stdout
+            -l list : convert also the files listed in "list" (one file per line)
+            -j #    : number of worker threads when several files are given
+                      (default: number of CPUs)
+            -J #    : compress each file in chunks by # threads. All the data arcs
+                      are initialized at the top of each chunk, and the estimated
+                      increase of the size is reported.
+                      Not used with -s, -u, -p, -x, -T, -F, or if the input is not
+                      a regular file.
+            -c #    : size of the chunks for -J in MB (default: from the file size, 1-16)
+            -       : output to stdout (only for one input file)
             -f      : force overwrite of output file
             -e #    : initialize the compression operation at every # epochs
                         When some part of the Compact RINEX file is lost, the data
@@ -15,140 +25,81 @@
             -d      : delete the input file if conversion finishes without errors
                       (i.e. exit code = 0 or 2).
                       This option does nothing if stdin is used for the input.
+            -b #    : size of the output block in MB (1-8, default: 4)
+            -u      : write out the output at every epoch (for real-time use)
+            -p      : read, convert and write in separate threads (for large files)
+            -x      : write the index of the initialized epochs to <output file>.idx
+                      (used by "CRX2RNX -t"; not with the output to stdout)
+            -F #    : follow a file that is still written: at its end, wait for the
+                      next epochs, polling every # ms, and write out each epoch as
+                      soon as it is complete (for real-time use)
+            -R file : with -F, stop at the end of the input once "file" exists
+                      (e.g. made by the receiver when it starts the next file)
+            -T end  : stop after the epoch at "end" (yyyy-mm-ddThh:mm:ss); the
+                      epochs after it are not compressed (nor deleted by -d)
+            -v      : recover the output in memory by CRX2RNX and compare it with the
+                      input (except the blanks at the ends of the lines); the first
+                      different line is reported as an error. The input must be a
+                      regular file (not with -F).
+            --stats : print the time of each phase of the conversion (reading,
+                      parsing, differencing, formatting, output), the numbers of
+                      epochs, satellites, fields, arc initializations, cycle slip
+                      resets and skipped epochs, and the output bytes by category
             -h      : display help message
 ****************************************************************************/
 
-#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
-#include <time.h>
+#include <mutex>
+#include <string>
+#include <vector>
 
-/***************************************************************************
-* 飺汾
-* ;,㷨޹أ
-****************************************************************************/
-
-#define VERSION  "ver.4.1.0"
-
-/***************************************************************************
-* 飺˳
-* ;ʶ˳״̬㷨޹أ
-****************************************************************************/
-#define EXIT_WARNING 2
-
-#ifndef EXIT_FAILURE
-#define EXIT_FAILURE 1
-#endif
-
-#ifndef EXIT_SUCCESS
-#define EXIT_SUCCESS 0
-#endif
-
-/***************************************************************************
-* 飺ڴ
-* ;ÿѭһѭ
-*       FLUSH_BUFF ȴӡ
-*       CLEAR_BUFF ֱ
-****************************************************************************/
-#define FLUSH_BUFF printf("%s",top_buff), *(p_buff = top_buff)='\0'
-#define CLEAR_BUFF *(p_buff = top_buff) = '\0'
-
-/***************************************************************************
-* 飺һЩ궨
-* ;һЩѹ㷨汾šڴ󳤶
-*       汾Ҫ
-*       ڴ󳤶Ҫڴʱȷֵ
-****************************************************************************/
-#define CRX_VERSION1 "1.0"    /* CRINEX version for RINEX 2.x */
-#define CRX_VERSION2 "3.0"    /* CRINEX version for RINEX 3.x */
-#define PROGNAME "RNX2CRX"
-#define MAXSAT    100         /* Maximum number of satellites observed at one epoch */
-#define MAXTYPE   100         /* Maximum number of data types for a GNSS system */
-#define MAXCLM   2048         /* Maximum columns in one line   (>MAXTYPE*19+3)  */
-#define MAX_BUFF_SIZE 204800  /* Maximum size of output buffer (>MAXSAT*(MAXTYPE*19+4)+60 */
-#define ARC_ORDER 3           /* order of difference to take    */
-
-/* define data structure for fields of clock offset and observation records */
-/* Those data will be handled as integers after eliminating decimal points.  */
-/* Since their size may exceeds range between LONG_MIN and LONG_MAX,         */
-/* they will be read with being divided properly into upper and lower digits */
-
-/***************************************************************************
-* 飺ʱʽṹ
-* ;ڴ洢ʱ䣬ݿܳlongݷΧ˽ʱз
-****************************************************************************/
-typedef struct clock_format {
-    long u[ARC_ORDER + 1];      //λ
-    long l[ARC_ORDER + 1];      //λ
-} clock_format;
-
-/***************************************************************************
-* 飺ݸʽṹ
-* ;ڴ洢ݣݿܳlongݷΧ˽ʱз
-****************************************************************************/
-typedef struct data_format {
-    long u[ARC_ORDER + 1];      //λ
-    long l[ARC_ORDER + 1];      //λ
-    int  order;
-} data_format;
+#include "crx_encoder.h"
+#include "../common/thread_pool.h"
 
 /***************************************************************************
-* 飺ȫֱ
-* ;ȫֱĶ弰ʼⲿֶıһҪÿһ
-*       ĺ壬ڶ㷨
+* 飺в
+* ;ѹ״̬ crx_encoder ֻвı
+*       Լתʱÿļļ˳
 ****************************************************************************/
-long ep_count = 0;
 long ep_reset = 0;
-long nl_count = 0;
-int rinex_version;          /* =2, 3 or 4 */
-int nsat, ntype, ntype_gnss[UCHAR_MAX], ntype_record[MAXSAT], clk_order = -1;
 int exit_status = EXIT_SUCCESS;
 int skip_strange_epoch = 0; /* default : stop with error */
 int delete_if_no_error = 0; /* default : not delete */
-int n_infile = 0;           /* number of input file (must be 0 or 1) */
-
-
-clock_format clk1 = { {0,0,0,0},{0,0,0,0} }; //ʱṹڴ洢ʱ
-clock_format clk0 = { {0,0,0,0},{0,0,0,0} }; //ʱṹڴ洢ʱ
-data_format dy0[MAXSAT][MAXTYPE], dy1[MAXSAT][MAXTYPE]; //ݽṹʱ
-char flag0[MAXSAT][MAXTYPE * 2], flag[MAXSAT][MAXTYPE * 2];
-char out_buff[MAX_BUFF_SIZE] = { 'x','\0' }; //Buffer洢飬λΪxλÿ
-char* top_buff = &out_buff[1], * p_buff;        //λȻΪxʣµλΪɵ
-char infile[MAXCLM];                        //ļ洢
-constexpr size_t C1 = sizeof("");               //һַȣ߿ܿǵַȵӰ죬ַж
-constexpr size_t C2 = sizeof(" ");              //ַ
-constexpr size_t C3 = sizeof("  ");             //ַ
-constexpr size_t C14 = sizeof("             "); //ʮĸַ
-
-char oldline[MAXCLM] = { '&','\0' };
-int nsat_old = 0;
+int force = 0;              /* overwrite if the output file exists */
+int nfout = 0;              /* =0 default output file name, =1 standard output */
+int nthread = 0;            /* number of worker threads (0: number of CPUs) */
+size_t block_size = DEFAULT_BLOCK_SIZE;  /* size of the output block */
+int flush_epoch = 0;        /* =1 flush the output at every epoch */
+int pipeline = 0;           /* =1 read, convert and write in separate threads */
+int make_index = 0;         /* =1 write the index of the initialized epochs */
+int nthread_file = 0;       /* threads compressing the chunks of one file (-J #) */
+size_t chunk_size = 0;      /* size of the chunks (-c #, 0: from the file size) */
+int follow = 0;             /* interval of polling the end of the input (-F # ms, 0: no) */
+const char* marker = NULL;  /* the input ends when this file exists (-R) */
+int use_end = 0;            /* =1 stop at t_end (-T) */
+epoch_time t_end;
+int verify = 0;             /* =1 compare the recovered output with the input (-v) */
+int show_stats = 0;         /* =1 print the time of the phases and the counts (--stats) */
+std::vector<std::string> infiles;   //ļб
+std::vector<std::string> outfiles;  //ļбַʾתļ
+std::vector<int> status;            //ÿļ˳
+std::mutex err_mutex;               //߳ͬʱϢʱ
 
 /***************************************************************************
 * 飺
-* ;㷨һЩmainã嶨ں
+* ;дѹ㷨 crx_encoder.cpp
 ****************************************************************************/
 void parse_args(int argc, char* argv[]);//ĲݲʼһЩȫֱԴļƣѹɹǷɾԴļȲã
-void header(void);//ļͷͷʼһЩȫֱԴļRNXļİ汾ȱ
-int  get_next_epoch(char* p_line);
-void skip_to_next(char* p_line);
-void initialize_all(char* oldline, int* nsat_old, int count);
-void put_event_data(char* p_line);
-void read_clock(char* line, int shift_cl);
-void process_clock(void);
-int  set_sat_table(char* p_new, char* p_old, int nsat_old, int* sattbl);
-int  read_more_sat(int n, char* p);
-void data(int* sattbl);
-char* strdiff(const char* s1, char* s2, char* ds);
-int  ggetline(data_format* py1, char* flag, char* sat_id, int* ntype_rec);
-void read_value(char* p, long* pu, long* pl);
-void take_diff(data_format* py1, data_format* py0);
-void putdiff(long dddu, long dddl);
-void put_clock(long du, long dl, int clk_order);
-int  read_chk_line(char* line);
-void error_exit(int error_no, char* string);
-void no_error_exit();
+void read_list(const char* listfile);
+int  set_outfile(size_t n);
+int  convert_file(size_t n);
+void file_error(int error_no, const char* string);
+void report_chunks(const char* name, const crx_encoder* encoder);
+void report_stats(const char* name, const conv_stats* stats);
+void error_exit(int error_no, const char* string);
 
 
 /***************************************************************************
@@ -157,112 +108,63 @@ void no_error_exit();
 *       ʱĲargvǸַ飬argcַ
 *       Ϊ.\RNX2CRX.exe test.rnx,argcֵΪ2argv[0]Ϊ
 *        .\RNX2CRX.exeargv[1]Ϊtest.rnxԴơ
+*       ļʱȷļҪѯǷ񸲸ǣ
+*        nthread ̲߳תÿļ˳롣
 ****************************************************************************/
 int main(int argc, char* argv[]) {
-
-    char newline[MAXCLM];
-    char dummy[2] = { '\0','\0' };
-    char* p, * p_event, * p_nsat, * p_satlst, * p_satold, * p_clock;
-    int sattbl[MAXSAT], i, j, shift_clk;
-    /* sattbl[i]: order (at the previous epoch) of i-th satellite */
-    /* (at the current epoch). -1 is set for the new satellites   */
+    crx_encoder* encoder;
+    conv_stats stats;
+    size_t i, n;
 
     parse_args(argc, argv);//
 
-    for (i = 0; i < UCHAR_MAX; i++) ntype_gnss[i] = -1;  /** -1 unless GNSS type is defined **/
-    header();
-    if (rinex_version == 2) {
-        p_event = &newline[28];  /** pointer to event flag **/
-        p_nsat = &newline[29];  /** pointer to n_sat **/
-        p_satlst = &newline[32];  /** pointer to satellite list **/
-        p_satold = &oldline[32];  /** pointer to n_sat of the previous epoch **/
-        p_clock = &newline[68];  /** pointer to clock offset data **/
-        shift_clk = 1;
-    }
-    else {
-        p_event = &newline[31];
-        p_nsat = &newline[32];
-        p_satlst = &newline[41];
-        p_satold = &oldline[41];
-        p_clock = &newline[41];
-        shift_clk = 4;
-    }
-
-    for (CLEAR_BUFF;; FLUSH_BUFF) {
-    SKIP:
-        if (!get_next_epoch(newline)) no_error_exit();
-
-        /*** if event flag > 1, then (1)output event data  */
-        /*** (2)initialize all data arcs, and continue to next epoch ***/
-        if (atoi(strncpy(dummy, p_event, C1)) > 1) {
-            put_event_data(newline);
-            initialize_all(oldline, &nsat_old, 0);
-            continue;
-        }
-
-        if (ep_reset > 0 && ++ep_count > ep_reset) initialize_all(oldline, &nsat_old, 1);
-
-        if (strchr(newline, '\0') > p_clock) {
-            read_clock(p_clock, shift_clk);        /**** read clock offset ****/
-        }
-        else {
-            clk_order = -1;                       /*** reset data arc for clock offset ***/
-        }
-
-        nsat = atoi(p_nsat);
-        if (nsat > MAXSAT) error_exit(8, newline);
-        if (nsat > 12 && rinex_version == 2) read_more_sat(nsat, p_satlst);  /*** read continuation lines ***/
-
-        /**** get observation ****/
-        for (i = 0, p = p_satlst; i < nsat; i++, p += 3) {
-            if (ggetline(dy1[i], flag[i], p, &ntype_record[i])) {
-                CLEAR_BUFF;
-                exit_status = EXIT_WARNING;
-                goto SKIP;
-            }
-        }
-        *p = '\0';    /*** terminate satellite list ***/
-
-        if (set_sat_table(p_satlst, p_satold, nsat_old, sattbl)) {
-            CLEAR_BUFF;
+    n = infiles.size();
+    if (n == 0) {      /*** stdin & stdout will be used if input file name is not given ***/
+        encoder = new crx_encoder;
+        encoder->ep_reset = ep_reset;
+        encoder->skip_strange_epoch = skip_strange_epoch;
+        encoder->block_size = block_size;
+        encoder->flush_epoch = flush_epoch;
+        encoder->pipeline = pipeline;
+        encoder->nthread = nthread_file;
+        encoder->chunk_size = chunk_size;
+        encoder->follow = follow;
+        encoder->marker = marker;
+        encoder->use_end = use_end;
+        encoder->t_end = t_end;
+        encoder->verify = verify;
+        if (show_stats) encoder->stats = &stats;
+        exit_status = encoder->convert(stdin, stdout);
+        if (exit_status == EXIT_FAILURE) encoder->print_error(stderr);
+        else report_chunks(NULL, encoder);
+        if (show_stats) report_stats(NULL, &stats);
+        delete encoder;
+        exit(exit_status);
+    }
+
+    outfiles.resize(n);
+    status.resize(n);
+    for (i = 0; i < n; i++) status[i] = set_outfile(i);
+
+    parallel_for(n, nthread, [](size_t k) {
+        if (status[k] == EXIT_SUCCESS && (nfout || !outfiles[k].empty())) status[k] = convert_file(k);
+    });
+
+    for (i = 0; i < n; i++) {
+        if (n > 1) fprintf(stderr, "%s : exit code = %d\n", infiles[i].c_str(), status[i]);
+        if (status[i] == EXIT_FAILURE) {
+            exit_status = EXIT_FAILURE;
+        }
+        else if (status[i] == EXIT_WARNING && exit_status == EXIT_SUCCESS) {
             exit_status = EXIT_WARNING;
-            continue;
-        }
-
-        /***********************************************************/
-        /**** print change of the line & clock offset difference ****/
-        /**** and data difference                               ****/
-        /***********************************************************/
-        p_buff = strdiff(oldline, newline, p_buff);
-        if (clk_order > -1) {
-            if (clk_order > 0) process_clock();            /**** process clock offset ****/
-            put_clock(clk1.u[clk_order], clk1.l[clk_order], clk_order);
-        }
-        else {
-            *p_buff++ = '\n';
-        }
-        data(sattbl); *p_buff = '\0';
-        /**************************************/
-        /**** save current epoch to buffer ****/
-        /**************************************/
-        nsat_old = nsat;
-        sprintf(oldline, "%s", newline);
-        clk0 = clk1;
-        for (i = 0; i < nsat; i++) {
-            strcpy(flag0[i], flag[i]);
-            for (j = 0; j < ntype_record[i]; j++) dy0[i][j] = dy1[i][j];
         }
     }
+    exit(exit_status);
 }
 /*---------------------------------------------------------------------*/
 void parse_args(int argc, char* argv[]) {
-    char* p;
-    char outfile[MAXCLM];//ļXX.crx
     char* progname;//
-    int force = 0, help = 0;
-    int nfout = 0;  /*** =0 default output file name ***/
-    /*** =1 standard output          ***/
-    FILE* ifp;
+    int help = 0, mbyte;
 
     progname = argv[0];//Ϊһ
 
@@ -272,9 +174,9 @@ void parse_args(int argc, char* argv[]) {
     for (; argc > 0; argc--, argv++) {
         //һַǡ-ǱȻļ
         if ((*argv)[0] != '-') {
-            //ļinfile
-            strncpy(infile, *argv, C1 * MAXCLM);
-            n_infile++;
+            //ļinfilesб
+            if (strlen(*argv) >= MAXCLM) error_exit(14, *argv);
+            infiles.push_back(*argv);
         }
         //-
         else if (strcmp(*argv, "-") == 0) {
@@ -297,527 +199,255 @@ void parse_args(int argc, char* argv[]) {
             argc--; argv++;
             sscanf(*argv, "%ld", &ep_reset);
         }
-        else if (strcmp(*argv, "-h") == 0) {
-            help = 1;
-        }
-        else {
-            help = 1;
-        }
-    }
-
-    if (strlen(infile) == MAXCLM) error_exit(14, infile);
-    if (help == 1 || n_infile > 1 || n_infile < 0) error_exit(1, progname);
-    if (n_infile == 0) return;  /*** stdin & stdout will be used if input file name is not given ***/
-
-    /***********************/
-    /*** open input file ***/
-    /***********************/
-    p = strrchr(infile, '.');
-    if (p == NULL || *(p + 4) != '\0'
-        || (toupper(*(p + 3)) != 'O'
-            && strcmp(p + 1, "RNX") != 0
-            && strcmp(p + 1, "rnx") != 0)
-        ) error_exit(4, p);
-
-    if ((ifp = fopen(infile, "r")) == NULL) error_exit(5, infile);
-
-    /************************/
-    /*** open output file ***/
-    /************************/
-    if (nfout == 0) {
-        strcpy(outfile, infile);
-        p = strrchr(outfile, '.');
-        if (*(p + 3) == 'o') { *(p + 3) = 'd'; }
-        else if (*(p + 3) == 'O') { *(p + 3) = 'D'; }
-        else if (strcmp(p + 1, "rnx") == 0) { strcpy((p + 1), "crx"); }
-        else if (strcmp(p + 1, "RNX") == 0) { strcpy((p + 1), "CRX"); }
-
-        if ((freopen(outfile, "r", stdout)) != NULL && force == 0) {
-            fprintf(stderr, "The file %s already exists. Overwrite?(n)", outfile);
-            if (getchar() != 'y') exit(EXIT_SUCCESS);
+        //-l,бļļ
+        else if (strcmp(*argv, "-l") == 0 && argc > 1) {
+            argc--; argv++;
+            read_list(*argv);
         }
-        freopen(outfile, "w", stdout);
-    }
-    fclose(ifp);
-    freopen(infile, "r", stdin);
-}
-/*---------------------------------------------------------------------*/
-void header(void) {
-    char line[MAXCLM], line2[41], timestring[20];
-    time_t tc = time(NULL);
-    struct tm* tp;
-
-    if ((tp = gmtime(&tc)) == NULL) tp = localtime(&tc);
-    strftime(timestring, C1 * 20, "%d-%b-%y %H:%M", tp);
-
-    /*** Check RINEX VERSION / TYPE ***/
-    read_chk_line(line);
-    if (strncmp(&line[60], "RINEX VERSION / TYPE", C1 * 20) != 0 ||
-        strncmp(&line[20], "O", C1) != 0) error_exit(15, line);
-
-    rinex_version = atoi(line);
-    if (rinex_version == 2) { printf("%-20.20s", CRX_VERSION1); }
-    else if (rinex_version == 3 || rinex_version == 4) { printf("%-20.20s", CRX_VERSION2); }
-    else { error_exit(15, line); }
-    printf("%-40.40s%-20.20s\n", "COMPACT RINEX FORMAT", "CRINEX VERS   / TYPE");
-
-    sprintf(line2, "%s %s", PROGNAME, VERSION);
-    printf("%-40.40s%-20.20sCRINEX PROG / DATE\n", line2, timestring);
-    printf("%s\n", line);
-    do {
-        read_chk_line(line);
-        printf("%s\n", line);
-        if (strncmp(&line[60], "# / TYPES OF OBSERV", C1 * 19) == 0 && line[5] != ' ') {
-            ntype = atoi(line);                                        /** for RINEX2 **/
+        //-j,߳
+        else if (strcmp(*argv, "-j") == 0 && argc > 1) {
+            argc--; argv++;
+            sscanf(*argv, "%d", &nthread);
         }
-        else if (strncmp(&line[60], "SYS / # / OBS TYPES", C1 * 19) == 0) { /** for RINEX3 **/
-            if (line[0] != ' ') ntype_gnss[(unsigned int)line[0]] = atoi(&line[3]);
-            if (ntype_gnss[(unsigned int)line[0]] > MAXTYPE) error_exit(16, line);
+        //-J,һļֿ鲢ѹ߳
+        else if (strcmp(*argv, "-J") == 0 && argc > 1) {
+            argc--; argv++;
+            if (sscanf(*argv, "%d", &nthread_file) != 1 || nthread_file < 1) help = 1;
         }
-    } while (strncmp(&line[60], "END OF HEADER", C1 * 13) != 0);
-}
-/*---------------------------------------------------------------------*/
-int  get_next_epoch(char* p_line) {
-    /**** find next epoch line.                                                          ****/
-    /**** If the line seems to be abnormal, print warning message                        ****/
-    /**** and skip until next epoch is found                                             ****/
-    /**** return value  0 : end of the file                                              ****/
-    /****               1 : normal end                                                   ****/
-    /****               2 : trouble in the line                                          ****/
-    char* p;
-
-    nl_count++;
-    if (fgets(p_line, MAXCLM, stdin) == NULL) return 0;  /*** EOF: exit program successfully ***/
-
-    if ((p = strchr(p_line, '\n')) == NULL) {
-        if (*p_line == '\032') return 0;              /** DOS EOF **/
-        if (*p_line != '\0' || feof(stdin) == 0) {
-            if (!skip_strange_epoch) error_exit(12, p_line);
-            skip_to_next(p_line);
-            return 2;
+        //-c,ֿĴСMB
+        else if (strcmp(*argv, "-c") == 0 && argc > 1) {
+            argc--; argv++;
+            if (sscanf(*argv, "%d", &mbyte) != 1 || mbyte < 1) help = 1;
+            else chunk_size = (size_t)mbyte * 1048576;
         }
-        fprintf(stderr, "WARNING: null characters are detected at the end of file --> neglected.\n");
-        exit_status = EXIT_WARNING;
-        return 0;
-    }
-    if (*(p - 1) == '\r') { *(--p) = '\0'; };                   /*** remove DOS CR/LF ***/
-    while (*--p == ' ' && p > p_line) {}; *++p = '\0';         /*** chop blank ***/
-
-    if (rinex_version == 2) {
-        if (strlen(p_line) < 29 || *p_line != ' '
-            || *(p_line + 27) != ' ' || !isdigit(*(p_line + 28))
-            || (*(p_line + 29) != ' ' && !isdigit(*(p_line + 29)) && *(p_line + 29) != '\0')) {
-            /**** ------- something strange is found in the epoch line ****/
-            if (!skip_strange_epoch) error_exit(6, p_line);
-            if (*(p_line + 18) != '.')  CLEAR_BUFF;
-            skip_to_next(p_line);
-            return 2;
+        //-b,ĴСMB
+        else if (strcmp(*argv, "-b") == 0 && argc > 1) {
+            argc--; argv++;
+            if (sscanf(*argv, "%d", &mbyte) != 1 || mbyte < 1 || mbyte > 8) help = 1;
+            else block_size = (size_t)mbyte * 1048576;
         }
-    }
-    else {    /* rinex_version == 3 or 4 */
-        if (*p_line != '>') {
-            if (!skip_strange_epoch) error_exit(6, p_line);
-            CLEAR_BUFF;
-            skip_to_next(p_line);
-            return 2;
+        //-u,ÿԪ
+        else if (strcmp(*argv, "-u") == 0) {
+            flush_epoch = 1;
         }
-        while (p < (p_line + 41)) *p++ = ' '; /*** pad blank ***/
-        *p = '\0';
-    }
-    return 1;
-}
-/*---------------------------------------------------------------------*/
-void skip_to_next(char* p_line) {
-    fprintf(stderr, " WARNING at line %ld: strange format. skip to next epoch.\n", nl_count);
-    exit_status = EXIT_WARNING;
-
-    if (rinex_version == 2) {
-        do {                               /**** try to find next epoch line ****/
-            read_chk_line(p_line);
-        } while (strlen(p_line) < 29 || *p_line != ' ' || *(p_line + 3) != ' '
-            || *(p_line + 6) != ' ' || *(p_line + 9) != ' '
-            || *(p_line + 12) != ' ' || *(p_line + 15) != ' '
-            || *(p_line + 26) != ' ' || *(p_line + 27) != ' '
-            || !isdigit(*(p_line + 28)) || !isspace(*(p_line + 29))
-            || (strlen(p_line) > 68 && *(p_line + 70) != '.'));
-    }
-    else {    /*** for RINEX3 ***/
-        do {
-            read_chk_line(p_line);
-        } while (*p_line != '>');
-    }
-    initialize_all(oldline, &nsat_old, 0);             /**** initialize all data ***/
-}
-/*---------------------------------------------------------------------*/
-void initialize_all(char* oldline, int* nsat_old, int count) {
-    strcpy(oldline, "&");        /**** initialize the epoch data arc ****/
-    clk_order = -1;             /**** initialize the clock data arc ****/
-    *nsat_old = 0;              /**** initialize the all satellite arcs ****/
-    ep_count = count;
-}
-/*---------------------------------------------------------------------*/
-void put_event_data(char* p_line) {
-    /**** This routine is called when event flag >1 is set.  ****/
-    /****      read # of event information lines and output  ****/
-    int i, n;
-    char* p;
-
-    if (rinex_version == 2) {
-        if (*(p_line + 26) == '.') error_exit(6, p_line);
-        printf("&%s\n", (p_line + 1));
-        if (strlen(p_line) > 29) {
-            n = atoi((p_line + 29));     /** n: number of lines to follow **/
-            for (i = 0; i < n; i++) {
-                read_chk_line(p_line);
-                printf("%s\n", p_line);
-                if (strncmp((p_line + 60), "# / TYPES OF OBSERV", C1 * 19) == 0 && *(p_line + 5) != ' ') {
-                    *flag[0] = '\0';
-                    ntype = atoi(p_line);
-                    if (ntype > MAXTYPE) error_exit(16, p_line);
-                }
-            }
+        else if (strcmp(*argv, "-p") == 0) {
+            pipeline = 1;
         }
-    }
-    else {
-        if (strlen(p_line) < 35 || *(p_line + 29) == '.') error_exit(6, p_line);
-        /* chop blanks that were padded in get_next_epoch */
-        p = strchr(p_line + 35, '\0'); while (*--p == ' ') {}; *++p = '\0';
-        printf("%s\n", p_line);
-        n = atoi((p_line + 32));         /** n: number of lines to follow **/
-        for (i = 0; i < n; i++) {
-            read_chk_line(p_line);
-            printf("%s\n", p_line);
-            if (strncmp((p_line + 60), "SYS / # / OBS TYPES", C1 * 19) == 0 && *p_line != ' ') {
-                *flag[0] = '\0';
-                ntype_gnss[(unsigned int)*p_line] = atoi((p_line + 3));
-                if (ntype_gnss[(unsigned int)*p_line] > MAXTYPE) error_exit(16, p_line);
-            }
+        else if (strcmp(*argv, "-x") == 0) {
+            make_index = 1;
         }
-    }
-}
-/*---------------------------------------------------------------------*/
-void read_clock(char* p_clock, int shift_clk) {
-    /****  read the clock offset value ****/
-    /**  *p_clock : pointer to beginning of clock data **/
-    char* p_dot;      /** pointer for decimal point **/
-    p_dot = p_clock + 2;
-    if (*p_dot != '.')error_exit(7, p_clock);
-
-    strncpy(p_dot, p_dot + 1, C1 * shift_clk);  /**** shift digits because of too  ****/
-    *(p_dot + shift_clk) = '.';             /**** many digits for fractional part ****/
-    sscanf(p_clock, "%ld.%ld", &clk1.u[0], &clk1.l[0]);
-    if (*p_clock == '-' || *(p_clock + 1) == '-') clk1.l[0] = -clk1.l[0];
-    if (clk_order < ARC_ORDER) clk_order++;
-    *p_clock = '\0';
-}
-/*---------------------------------------------------------------------*/
-void process_clock(void) {
-    int i;
-    for (i = 0; i < clk_order; i++) {
-        clk1.u[i + 1] = clk1.u[i] - clk0.u[i];
-        clk1.l[i + 1] = clk1.l[i] - clk0.l[i];
-    }
-}
-/*---------------------------------------------------------------------*/
-int  set_sat_table(char* p_new, char* p_old, int nsat_old, int* sattbl) {
-    /**** sattbl : order of the satellites in the previous epoch   ****/
-    /**** if *sattbl is set to  -1, the data arc for the satellite ****/
-    /**** will be initialized                                      ****/
-    int i, j;
-    char* ps;
-
-    for (i = 0; i < nsat; i++, p_new += 3) {
-        *sattbl = -1;
-        ps = p_old;
-        for (j = 0; j < nsat_old; j++, ps += 3) {
-            if (strncmp(p_new, ps, C3) == 0) {
-                *sattbl = j;
-                break;
-            }
+        //-F,дļѯ룩
+        else if (strcmp(*argv, "-F") == 0 && argc > 1) {
+            argc--; argv++;
+            if (sscanf(*argv, "%d", &follow) != 1 || follow < 1) help = 1;
         }
-        /*** check double entry ***/
-        for (j = i + 1, ps = p_new + 3; j < nsat; j++, ps += 3) {
-            if (strncmp(p_new, ps, C3) == 0) {
-                if (!skip_strange_epoch) error_exit(13, p_new);
-                fprintf(stderr, "WARNING:Duplicated satellite in one epoch at line %ld. ... skip\n", nl_count);
-                return 1;
-            }
+        //-R,ļֺļֻ
+        else if (strcmp(*argv, "-R") == 0 && argc > 1) {
+            argc--; argv++;
+            marker = *argv;
         }
-        sattbl++;
-    }
-    return 0;
-}
-/*---------------------------------------------------------------------*/
-int  read_more_sat(int n, char* p) {
-    /**** read continuation line of satellite list (for RINEX2) ****/
-    char line[MAXCLM];
-
-    do {
-        p += 36;
-        if (read_chk_line(line)) return 1;
-        /**** append satellite table ****/
-        if (line[2] == ' ') {
-            sprintf(p, "%s", &line[32]);
+        //-T,ѹʱ̵ԪΪֹ
+        else if (strcmp(*argv, "-T") == 0 && argc > 1) {
+            argc--; argv++;
+            if (parse_time(*argv, &t_end) != 0) help = 1;
+            use_end = 1;
         }
-        else {                        /*** for the files before clarification of format ***/
-            sprintf(p, "%s", &line[0]); /*** by W.Gurtner (IGS mail #1577)                ***/
+        //-v,ضУѹ
+        else if (strcmp(*argv, "-v") == 0) {
+            verify = 1;
         }
-        n -= 12;
-    } while (n > 12);
-    return 0;
-}
-/*---------------------------------------------------------------------*/
-void data(int* sattbl) {
-    /********************************************************************/
-    /*  Function : output the 3rd order difference of data              */
-    /*       u : upper X digits of the data                             */
-    /*       l : lower 5 digits of the data                             */
-    /*            ( y = u*100 + l/1000 )                                */
-    /*   py->u : upper digits of the 3rd order difference of the data   */
-    /*   py->l : lower digits of the 3rd order difference of the data   */
-    /********************************************************************/
-    data_format* py1;
-    int  i, j, * i0;
-    char* p;
-
-    for (i = 0, i0 = sattbl; i < nsat; i++, i0++) {
-        for (j = 0, py1 = dy1[i]; j < ntype_record[i]; j++, py1++) {
-            if (py1->order >= 0) {       /*** if the numerical data field is non-blank ***/
-                if (*i0 < 0 || dy0[*i0][j].order == -1) {
-                    /**** initialize the data arc ****/
-                    py1->order = 0; p_buff += sprintf(p_buff, "%d&", ARC_ORDER);
-                }
-                else {
-                    take_diff(py1, &(dy0[*i0][j]));
-                    if (labs(py1->u[py1->order]) > 100000) {
-                        /**** initialization of the arc for large cycle slip  ****/
-                        py1->order = 0; p_buff += sprintf(p_buff, "%d&", ARC_ORDER);
-                    }
-                }
-                putdiff(py1->u[py1->order], py1->l[py1->order]);
-            }
-            else if (*i0 >= 0 && rinex_version == 2) {
-                /**** CRINEX1 (RINEX2) initialize flags for blank field, not put '&' ****/
-                flag0[*i0][j * 2] = flag0[*i0][j * 2 + 1] = ' ';
-            }
-            if (j < ntype_record[i] - 1) *p_buff++ = ' ';   /** ' ' :field separator **/
+        //--stats,׶εʱͼ
+        else if (strcmp(*argv, "--stats") == 0) {
+            show_stats = 1;
         }
-        *(p_buff++) = ' ';  /* write field separator */
-        if (*i0 < 0) {             /* if new satellite initialize all LLI & SN flags */
-            if (rinex_version == 2) {
-                p_buff = strdiff("", flag[i], p_buff);
-            }
-            else {          /*  replace space with '&' for CRINEX3(RINEX3)  */
-                for (p = flag[i]; *p != '\0'; p++) *p_buff++ = (*p == ' ') ? '&' : *p;
-                *p_buff++ = '\n'; *p_buff = '\0';
-            }
+        else if (strcmp(*argv, "-h") == 0) {
+            help = 1;
         }
         else {
-            p_buff = strdiff(flag0[*i0], flag[i], p_buff);
-            //test
+            help = 1;
         }
     }
+
+    if (help == 1 || (nfout == 1 && infiles.size() > 1)) error_exit(1, progname);
+    if (make_index && (nfout == 1 || infiles.empty())) error_exit(1, progname);  /** index needs an output file **/
+    if (marker != NULL && follow == 0) error_exit(1, progname);
 }
 /*---------------------------------------------------------------------*/
-char* strdiff(const char* s1, char* s2, char* ds) {
-    /********************************************************************/
-    /**   copy only the difference of string s2 from string s1         **/
-    /**   '&' is marked when some character changed to a space         **/
-    /**   trailing blank is eliminated and '/n' is added               **/
-    /********************************************************************/
-    for (; *s1 != '\0' && *s2 != '\0'; s2++) {
-        if (*s2 == *(s1++))
-            *ds++ = ' ';
-        else if (*s2 == ' ')
-            *ds++ = '&';
-        else
-            *ds++ = *s2;
+void read_list(const char* listfile) {
+    /**** read names of the input files (one file per line) ****/
+    char line[MAXCLM], * p;
+    FILE* fp;
+
+    if ((fp = fopen(listfile, "r")) == NULL) error_exit(5, listfile);
+    while (fgets(line, MAXCLM, fp) != NULL) {
+        if ((p = strchr(line, '\n')) == NULL) error_exit(14, line);
+        while (p > line && isspace((unsigned char)*(p - 1))) p--;   /** chop CR/LF and blank **/
+        *p = '\0';
+        if (line[0] != '\0') infiles.push_back(line);
     }
-    strcpy(ds, s1);
-    for (; *ds; ds++) { if (*ds != ' ') *ds = '&'; }
-    while (*s2) *ds++ = *s2++;
-
-    for (ds--; *ds == ' '; ds--);    /*** find pointer of last non-space character ***/
-    *++ds = '\n'; *++ds = '\0';       /*** chop spaces at the end of the line ***/
-    return ds;
+    fclose(fp);
 }
 /*---------------------------------------------------------------------*/
-int  ggetline(data_format* py1, char* flag, char* sat_id, int* ntype_rec) {
-    /**** read data line for one satellite and       ****/
-    /**** set data difference and flags to variables ****/
-    char line[MAXCLM], * p, * pmax, * p_1st_rec;
-    int i, j, nfield, max_field;
+int  set_outfile(size_t n) {
+    /**** check the n-th input file and set the name of the output file. ****/
+    /**** This is done in the main thread because the user may be asked  ****/
+    /**** whether the existing file is overwritten.                      ****/
+    char outfile[MAXCLM];//ļXX.crx
+    char answer[8];
+    const char* infile = infiles[n].c_str();
+    char* p;
+    FILE* fp;
 
-    if (read_chk_line(line)) return 1;
-    if (rinex_version == 2) {             /** for RINEX2 **/
-        max_field = 5;                             /** maximum data types in one line **/
-        *ntype_rec = ntype;                        /** # of data types for the satellite **/
-        p_1st_rec = line;                          /** pointer to the start of the first record **/
+    /***********************/
+    /*** check input file ***/
+    /***********************/
+    p = strrchr((char*)infile, '.');
+    if (p == NULL || *(p + 4) != '\0'
+        || (toupper(*(p + 3)) != 'O'
+            && strcmp(p + 1, "RNX") != 0
+            && strcmp(p + 1, "rnx") != 0)
+        ) {
+        file_error(4, p);
+        return EXIT_FAILURE;
     }
-    else {                                /** for RINEX3 **/
-        strncpy(sat_id, line, C3);                   /** put satellite ID to the list of satellites **/
-        max_field = *ntype_rec = ntype_gnss[(unsigned int)line[0]];  /*** # of data types for the GNSS system ***/
-        if (max_field < 0) {
-            if (!skip_strange_epoch) error_exit(21, line);
-            fprintf(stderr, "WARNING at line %ld. : GNSS type '%c' is not defined in the header. ... skip\n", nl_count, (unsigned int)line[0]);
-            return 1;
-        }
-        p_1st_rec = line + 3;
+
+    if ((fp = fopen(infile, "r")) == NULL) {
+        file_error(5, infile);
+        return EXIT_FAILURE;
     }
-    for (i = 0; i < *ntype_rec; i += max_field) {                 /* for each line */
-        nfield = (*ntype_rec - i < max_field ? *ntype_rec - i : max_field); /*** expected # of data fields in the line ***/
-        pmax = p_1st_rec + 16 * nfield;
+    fclose(fp);
 
-        /*** Cut or pad spaces. Detect error if there is any character after *pmax ***/
-        p = strchr(line, '\0');
-        if (p < pmax) {
-            while (p < pmax) *p++ = ' '; *p = '\0';
-        }
-        else {
-            for (*p = ' '; p > pmax && *p == ' '; p--) {};
-            if (p > pmax) {
-                if (!skip_strange_epoch) error_exit(9, line);
-                fprintf(stderr, "WARNING: mismatch of number of the data types at line %ld. ... skip\n", nl_count);
-                return 1;
-            }
-        }
+    /*************************/
+    /*** check output file ***/
+    /*************************/
+    if (nfout == 0) {
+        strcpy(outfile, infile);
+        p = strrchr(outfile, '.');
+        if (*(p + 3) == 'o') { *(p + 3) = 'd'; }
+        else if (*(p + 3) == 'O') { *(p + 3) = 'D'; }
+        else if (strcmp(p + 1, "rnx") == 0) { strcpy((p + 1), "crx"); }
+        else if (strcmp(p + 1, "RNX") == 0) { strcpy((p + 1), "CRX"); }
 
-        /*** parse the line (read value into py1) ***/
-        for (j = 0, p = p_1st_rec; j < nfield; j++, p += 16, py1++) {
-            if (*(p + 10) == '.') {
-                *flag++ = *(p + 14);
-                *flag++ = *(p + 15);
-                *(p + 14) = '\0';
-                read_value(p, &(py1->u[0]), &(py1->l[0]));
-                py1->order = 0;
-            }
-            else if (strncmp(p, "              ", C14) == 0) {
-                if (rinex_version == 2 && strncmp((p + 14), "  ", C2) != 0) error_exit(20, line);
-                *flag++ = *(p + 14);
-                *flag++ = *(p + 15);
-                py1->order = -1;
-            }
-            else {
-                if (!skip_strange_epoch) error_exit(10, p);
-                fprintf(stderr, "WARNING: abnormal data field at line %ld....skip\n", nl_count);
-                return 1;
+        if ((fp = fopen(outfile, "r")) != NULL) {
+            fclose(fp);
+            if (force == 0) {
+                fprintf(stderr, "The file %s already exists. Overwrite?(n)", outfile);
+                if (fgets(answer, sizeof(answer), stdin) == NULL || answer[0] != 'y') return EXIT_SUCCESS;
             }
         }
-        if (i + max_field < *ntype_rec) {
-            if (read_chk_line(line)) return 1;   /* read continuation line */
-        }
+        outfiles[n] = outfile;
     }
-    *flag = '\0';
-    return 0;
+    return EXIT_SUCCESS;
 }
 /*---------------------------------------------------------------------*/
-void read_value(char* p, long* pu, long* pl) {
-    /**** divide the data into lower 5 digits and upper digits     ****/
-    /**** input p :  pointer to one record (14 characters + '\0')  ****/
-    /**** output  *pu, *pl: upper and lower digits the data        ****/
-
-    char* p7, * p8, * p9;
-    p7 = p + 7;
-    p8 = p7 + 1;
-    p9 = p8 + 1;
-
-    *(p9 + 1) = *p9;            /* shift two digits: ex. 123.456 -> 1223456,  -.345 ->   -345 */
-    *p9 = *p8;                /*                       -12.345 -> -112345, -1.234 -> --1234 */
-    *pl = atol(p9);           /*                         0.123 ->  . 0123, -0.123 -> --0123 */
-
-    if (*p7 == ' ') {
-        *pu = 0;
-    }
-    else if (*p7 == '-') {
-        *pu = 0;
-        *pl = -*pl;
+int  convert_file(size_t n) {
+    /**** convert the n-th input file (called in a worker thread) ****/
+    crx_encoder* encoder;
+    crx_index index;
+    conv_stats stats;
+    FILE* ifp, * ofp;
+    int rc, end_reached;
+
+    if ((ifp = fopen(infiles[n].c_str(), "r")) == NULL) {
+        file_error(5, infiles[n].c_str());
+        return EXIT_FAILURE;
+    }
+    if (nfout == 1) {
+        ofp = stdout;
+    }
+    else if ((ofp = fopen(outfiles[n].c_str(), "w")) == NULL) {
+        fclose(ifp);
+        file_error(5, outfiles[n].c_str());
+        return EXIT_FAILURE;
+    }
+
+    encoder = new crx_encoder;
+    encoder->ep_reset = ep_reset;
+    encoder->skip_strange_epoch = skip_strange_epoch;
+    encoder->block_size = block_size;
+    encoder->flush_epoch = flush_epoch;
+    encoder->pipeline = pipeline;
+    encoder->nthread = nthread_file;
+    encoder->chunk_size = chunk_size;
+    encoder->follow = follow;
+    encoder->marker = marker;
+    encoder->use_end = use_end;
+    encoder->t_end = t_end;
+    encoder->verify = verify;
+    if (make_index) encoder->index = &index;
+    if (show_stats) encoder->stats = &stats;
+    rc = encoder->convert(ifp, ofp);
+    end_reached = encoder->end_reached;
+    if (rc == EXIT_FAILURE) {
+        std::lock_guard<std::mutex> lock(err_mutex);
+        if (infiles.size() > 1) fprintf(stderr, "%s :\n", infiles[n].c_str());
+        encoder->print_error(stderr);
     }
     else {
-        *p8 = '.';
-        *pu = atol(p);
-        if (*pu < 0) *pl = -*pl;
+        report_chunks(infiles[n].c_str(), encoder);
     }
-}
-/*---------------------------------------------------------------------*/
-void take_diff(data_format* py1, data_format* py0) {
-    int k;
+    if (show_stats) report_stats(infiles[n].c_str(), &stats);
+    delete encoder;
 
-    py1->order = py0->order;
-    if (py1->order < ARC_ORDER) (py1->order)++;
-    if (py1->order > 0) {
-        for (k = 0; k < py1->order; k++) {
-            py1->u[k + 1] = py1->u[k] - py0->u[k];
-            py1->l[k + 1] = py1->l[k] - py0->l[k];
-        }
+    fclose(ifp);
+    if (ofp != stdout) fclose(ofp);
+    if (make_index && rc != EXIT_FAILURE && index.write(outfiles[n].c_str()) != 0) {
+        file_error(5, (outfiles[n] + INDEX_SUFFIX).c_str());
     }
+    if (delete_if_no_error && rc == EXIT_SUCCESS && !end_reached) remove(infiles[n].c_str());  /** not all converted **/
+    return rc;
 }
 /*---------------------------------------------------------------------*/
-void putdiff(long dddu, long dddl) {
-
-    dddu += dddl / 100000; dddl %= 100000;
-    if (dddu < 0 && dddl>0) {
-        dddu++; dddl -= 100000;
-    }
-    else if (dddu > 0 && dddl < 0) {
-        dddu--; dddl += 100000;
-    }
-
-    if (dddu == 0) {
-        p_buff += sprintf(p_buff, "%ld", dddl);
+void file_error(int error_no, const char* string) {
+    /**** messages for the errors on each file (the conversion of ****/
+    /**** the other files is continued)                           ****/
+    std::lock_guard<std::mutex> lock(err_mutex);
+    if (error_no == 4) {
+        fprintf(stderr, "ERROR : invalid file name  %s\n", string);
+        fprintf(stderr, "The extension of the input file name should be [.??o] or [.rnx].\n");
+        fprintf(stderr, "To convert the files whose name is not fit to the above conventions,\n");
+        fprintf(stderr, "use of this program as a filter is also possible. \n");
+        fprintf(stderr, "    for example)  cat file.in | %s - > file.out\n", PROGNAME);
     }
-    else {
-        p_buff += sprintf(p_buff, "%ld%5.5ld", dddu, labs(dddl));
+    if (error_no == 5) {
+        fprintf(stderr, "ERROR : can't open %s\n", string);
     }
 }
 /*---------------------------------------------------------------------*/
-void put_clock(long du, long dl, int c_order) {
-    /***********************************/
-    /****  output clock diff. data  ****/
-    /***********************************/
-    du += dl / 100000000; dl %= 100000000;
-    if (du < 0 && dl>0) {
-        du++; dl -= 100000000;
-    }
-    else if (du > 0 && dl < 0) {
-        du--; dl += 100000000;
-    }
-    if (c_order == 0) p_buff += sprintf(p_buff, "%d&", ARC_ORDER);
-    if (du == 0) {
-        p_buff += sprintf(p_buff, "%ld\n", dl);
-    }
-    else {
-        p_buff += sprintf(p_buff, "%ld%8.8ld\n", du, labs(dl));
-    }
+void report_chunks(const char* name, const crx_encoder* encoder) {
+    /**** size added by the initialization at the top of the chunks (-J) ****/
+    long long bytes = (encoder->penalty > 0) ? encoder->penalty : 0;
+
+    if (encoder->nchunk < 2) return;
+    std::lock_guard<std::mutex> lock(err_mutex);
+    if (name != NULL) fprintf(stderr, "%s : ", name);
+    fprintf(stderr, "%d chunks, about %lld bytes (%.2f%%) added by the initialization at the top of the chunks.\n",
+        encoder->nchunk, bytes, (encoder->out_bytes > 0) ? 100.0 * (double)bytes / (double)encoder->out_bytes : 0.0);
 }
 /*---------------------------------------------------------------------*/
-int  read_chk_line(char* line) {
-    char* p;
-    /***************************************/
-    /* Read and check one line.            */
-    /* The end of the line should be '\n'. */
-    /***************************************/
-    nl_count++;
-    if (fgets(line, MAXCLM, stdin) == NULL) error_exit(11, line);
-    if ((p = strchr(line, '\n')) == NULL) {
-        if (fgetc(stdin) == EOF) {
-            error_exit(11, line);
-        }
-        else {
-            if (!skip_strange_epoch) error_exit(12, line);
-            fprintf(stderr, "WARNING: null character is found or the line is too long (>%d) at line %ld.\n", MAXCLM, nl_count);
-            return 1;
-        }
-    }
-    if (*(p - 1) == '\r')p--;   /*** check DOS CR/LF ***/
-    while (*--p == ' ' && p > line) {}; *++p = '\0';   /** Chop blank **/
-    return 0;
+void report_stats(const char* name, const conv_stats* stats) {
+    /**** time of the phases and the counts of one file (--stats) ****/
+    std::lock_guard<std::mutex> lock(err_mutex);
+    if (name != NULL) fprintf(stderr, "%s : ", name);
+    fprintf(stderr, "%s statistics\n", PROGNAME);
+    stats->print(stderr, 1);
 }
 /*---------------------------------------------------------------------*/
-void error_exit(int error_no, char* string) {
+void error_exit(int error_no, const char* string) {
     if (error_no == 1) {
-        fprintf(stderr, "Usage: %s [file] [-] [-f] [-e # of epochs] [-s] [-d] [-h]\n", string);
+        fprintf(stderr, "Usage: %s [file ...] [-l list] [-j #] [-J #] [-c #] [-] [-f] [-e # of epochs] [-s] [-d] [-b #] [-u] [-p] [-x]\n"
+            "        [-F #] [-R file] [-T end] [-v] [--stats] [-h]\n", string);
         fprintf(stderr, "    stdin and stdout are used if input file name is not given.\n");
-        fprintf(stderr, "    -       : output to stdout\n");
+        fprintf(stderr, "    -l list : convert also the files listed in \"list\" (one file per line)\n");
+        fprintf(stderr, "    -j #    : number of worker threads when several files are given\n");
+        fprintf(stderr, "              (default: number of CPUs)\n");
+        fprintf(stderr, "    -J #    : compress each file in chunks by # threads. All the data arcs\n");
+        fprintf(stderr, "              are initialized at the top of each chunk, and the estimated\n");
+        fprintf(stderr, "              increase of the size is reported.\n");
+        fprintf(stderr, "              Not used with -s, -u, -p, -x, -T, -F, or if the input is not\n");
+        fprintf(stderr, "              a regular file.\n");
+        fprintf(stderr, "    -c #    : size of the chunks for -J in MB (default: from the file size, 1-16)\n");
+        fprintf(stderr, "    -       : output to stdout (only for one input file)\n");
         fprintf(stderr, "    -f      : force overwrite of output file\n");
         fprintf(stderr, "    -e #    : initialize the compression operation at every # epochs\n");
         fprintf(stderr, "              When some part of the Compact RINEX file is lost, the data\n");
@@ -829,95 +459,40 @@ void error_exit(int error_no, char* string) {
         fprintf(stderr, "    -d      : delete the input file if conversion finishes without errors\n");
         fprintf(stderr, "              (i.e. exit code = %d or %d).\n", EXIT_SUCCESS, EXIT_WARNING);
         fprintf(stderr, "              This option does nothing if stdin is used for the input.\n");
+        fprintf(stderr, "    -b #    : size of the output block in MB (1-8, default: %d)\n", DEFAULT_BLOCK_SIZE / 1048576);
+        fprintf(stderr, "    -u      : write out the output at every epoch (for real-time use)\n");
+        fprintf(stderr, "    -p      : read, convert and write in separate threads (for large files)\n");
+        fprintf(stderr, "    -x      : write the index of the initialized epochs to <output file>%s\n", INDEX_SUFFIX);
+        fprintf(stderr, "              (used by \"CRX2RNX -t\"; not with the output to stdout)\n");
+        fprintf(stderr, "    -F #    : follow a file that is still written: at its end, wait for the\n");
+        fprintf(stderr, "              next epochs, polling every # ms, and write out each epoch as\n");
+        fprintf(stderr, "              soon as it is complete (for real-time use)\n");
+        fprintf(stderr, "    -R file : with -F, stop at the end of the input once \"file\" exists\n");
+        fprintf(stderr, "              (e.g. made by the receiver when it starts the next file)\n");
+        fprintf(stderr, "    -T end  : stop after the epoch at \"end\" (yyyy-mm-ddThh:mm:ss); the\n");
+        fprintf(stderr, "              epochs after it are not compressed (nor deleted by -d)\n");
+        fprintf(stderr, "    -v      : recover the output in memory by CRX2RNX and compare it with the\n");
+        fprintf(stderr, "              input (except the blanks at the ends of the lines); the first\n");
+        fprintf(stderr, "              different line is reported as an error. The input must be a\n");
+        fprintf(stderr, "              regular file (not with -F).\n");
+        fprintf(stderr, "    --stats : print the time of each phase of the conversion (reading,\n");
+        fprintf(stderr, "              parsing, differencing, formatting, output), the numbers of\n");
+        fprintf(stderr, "              epochs, satellites, fields, arc initializations, cycle slip\n");
+        fprintf(stderr, "              resets and skipped epochs, and the output bytes by category\n");
         fprintf(stderr, "    -h      : display this message\n\n");
+        fprintf(stderr, "    When several files are given, the exit code of each file is printed\n");
+        fprintf(stderr, "    at the end and the worst one is returned.\n");
         fprintf(stderr, "    exit code = %d (success)\n", EXIT_SUCCESS);
         fprintf(stderr, "              = %d (error)\n", EXIT_FAILURE);
         fprintf(stderr, "              = %d (warning)\n", EXIT_WARNING);
         fprintf(stderr, "    [version : %s]\n", VERSION);
         exit(EXIT_FAILURE);
     }
-    if (error_no == 4) {
-        fprintf(stderr, "ERROR : invalid file name  %s\n", string);
-        fprintf(stderr, "The extension of the input file name should be [.??o] or [.rnx].\n");
-        fprintf(stderr, "To convert the files whose name is not fit to the above conventions,\n");
-        fprintf(stderr, "use of this program as a filter is also possible. \n");
-        fprintf(stderr, "    for example)  cat file.in | %s - > file.out\n", PROGNAME);
-        exit(EXIT_FAILURE);
-    }
-    if (error_no == 5) {
-        fprintf(stderr, "ERROR : can't open %s\n", string);
-        exit(EXIT_FAILURE);
-    }
-    if (error_no == 6) {
-        fprintf(stderr, "ERROR when reading line %ld.\n", nl_count);
-        fprintf(stderr, "     start>%s<end\n", string);
-        exit(EXIT_FAILURE);
-    }
-    if (error_no == 7) {
-        fprintf(stderr, "ERROR at line %ld: invalid format for clock offset.\n", nl_count);
-        fprintf(stderr, "     start>%s<end\n", string);
-        exit(EXIT_FAILURE);
-    }
-    if (error_no == 8) {
-        fprintf(stderr, "ERROR at line %ld : number of satellites exceed the maximum(%d).\n", nl_count, MAXSAT);
-        fprintf(stderr, "     start>%s<end\n", string);
-        exit(EXIT_FAILURE);
-    }
-    if (error_no == 9) {
-        fprintf(stderr, "ERROR at line %ld : mismatch of number of the data types.\n", nl_count);
-        fprintf(stderr, "     start>%s<end\n", string);
-        exit(EXIT_FAILURE);
-    }
-    if (error_no == 10) {
-        fprintf(stderr, "ERROR at line %ld : abnormal data field.\n", nl_count);
-        fprintf(stderr, "     start>%s<end\n", string);
-        exit(EXIT_FAILURE);
-    }
-    if (error_no == 11) {
-        fprintf(stderr, "ERROR : The RINEX file seems to be truncated in the middle.\n");
-        fprintf(stderr, "        The conversion is interrupted after reading line %ld :\n", nl_count);
-        fprintf(stderr, "        start>%s<end\n", string);
-        exit(EXIT_FAILURE);
-    }
-    if (error_no == 12) {
-        fprintf(stderr, "ERROR at line %ld. : null character is found or the line is too long (>%d).\n", nl_count, MAXCLM);
-        fprintf(stderr, "     start>%s<end\n", string);
-        exit(EXIT_FAILURE);
-    }
-    if (error_no == 13) {
-        fprintf(stderr, "ERROR at line %ld. : Duplicated satellite in one epoch.\n", nl_count);
-        fprintf(stderr, "     start>%s<end\n", string);
-        exit(EXIT_FAILURE);
-    }
     if (error_no == 14) {
-        fprintf(stderr, "ERROR at line %ld. : Length of file name exceed MAXCLM(%d).\n", nl_count, MAXCLM);
-        fprintf(stderr, "     start>%s<end\n", string);
-        exit(EXIT_FAILURE);
-    }
-    if (error_no == 15) {
-        fprintf(stderr, "The first line is :\n%s\n\n", string);
-        fprintf(stderr, "ERROR : The file format is not valid. This program is applicable\n");
-        fprintf(stderr, "        only to RINEX Version 2/3/4 Observation file.\n");
-        exit(EXIT_FAILURE);
-    }
-    if (error_no == 16) {
-        fprintf(stderr, "ERROR at line %ld. : Number of data types exceed MAXTYPE(%d).\n", nl_count, MAXTYPE);
+        fprintf(stderr, "ERROR at line %ld. : Length of file name exceed MAXCLM(%d).\n", 0L, MAXCLM);
         fprintf(stderr, "     start>%s<end\n", string);
         exit(EXIT_FAILURE);
     }
-    if (error_no == 20) {
-        fprintf(stderr, "ERROR at line %ld. : data is blank but there is flag.\n", nl_count);
-        fprintf(stderr, "     start>%s<end\n", string);
-        exit(EXIT_FAILURE);
-    }
-    if (error_no == 21) {
-        fprintf(stderr, "ERROR at line %ld. : GNSS type '%c' is not defined in the header.\n", nl_count, (unsigned int)string[0]);
-        fprintf(stderr, "     start>%s<end\n", string);
-        exit(EXIT_FAILURE);
-    }
-}
-/*---------------------------------------------------------------------*/
-void no_error_exit() {
-    if (delete_if_no_error && exit_status != 2 && n_infile == 1)  remove(infile);
-    exit(exit_status);
+    file_error(error_no, string);
+    exit(EXIT_FAILURE);
 }
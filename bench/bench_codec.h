@@ -0,0 +1,17 @@
+/****************************************************************************/
+/*     bench_codec.h : RNX2CRX and CRX2RNX called by crx_bench              */
+/*                                                                          */
+/*     crx_encoder.h and crx_decoder.h can not be included in one source    */
+/*     file (both define PROGNAME, VERSION, MAXSAT, ...), so each of them   */
+/*     is called from a source file of its own. The return value is the    */
+/*     exit code of the program; the error is printed to stderr.           */
+/****************************************************************************/
+#ifndef BENCH_CODEC_H
+#define BENCH_CODEC_H
+
+#include <stdio.h>
+
+int  bench_compress(FILE* in, FILE* out, int nthread);     /* RNX2CRX (-J nthread) */
+int  bench_decompress(FILE* in, FILE* out, int nthread);   /* CRX2RNX (-J nthread) */
+
+#endif
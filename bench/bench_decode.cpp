@@ -0,0 +1,17 @@
+/****************************************************************************/
+/*     bench_decode.cpp : CRX2RNX called by crx_bench                       */
+/****************************************************************************/
+
+#include "bench_codec.h"
+#include "../CRX2RNX/crx_decoder.h"
+
+/*---------------------------------------------------------------------*/
+int  bench_decompress(FILE* in, FILE* out, int nthread) {
+    crx_decoder decoder;
+    int rc;
+
+    decoder.nthread = nthread;
+    rc = decoder.convert(in, out);
+    if (rc == EXIT_FAILURE) decoder.print_error(stderr);
+    return rc;
+}
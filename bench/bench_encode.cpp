@@ -0,0 +1,17 @@
+/****************************************************************************/
+/*     bench_encode.cpp : RNX2CRX called by crx_bench                       */
+/****************************************************************************/
+
+#include "bench_codec.h"
+#include "../RNX2CRX/crx_encoder.h"
+
+/*---------------------------------------------------------------------*/
+int  bench_compress(FILE* in, FILE* out, int nthread) {
+    crx_encoder encoder;
+    int rc;
+
+    encoder.nthread = nthread;
+    rc = encoder.convert(in, out);
+    if (rc == EXIT_FAILURE) encoder.print_error(stderr);
+    return rc;
+}
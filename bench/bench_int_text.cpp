@@ -0,0 +1,174 @@
+/****************************************************************************/
+/*     bench_int_text.cpp : microbenchmark of the integer emitters          */
+/*                                                                          */
+/*     Usage: bench_int_text [RINEX file ...]                               */
+/*                                                                          */
+/*     1) Formats the same set of differenced values as in putdiff() and    */
+/*        put_clock() of RNX2CRX, both with sprintf() of the upper/lower    */
+/*        digits (the original method) and with put_llong(), checks that    */
+/*        the texts are identical, and reports the speed of each in MB/s    */
+/*        of Compact RINEX text.                                            */
+/*     2) Compresses each RINEX file given as an argument and reports the   */
+/*        speed of RNX2CRX in MB/s of input and of output.                  */
+/*                                                                          */
+/*     Build: see CMakeLists.txt in the top directory (target               */
+/*        bench_int_text).                                                  */
+/****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+#include "../RNX2CRX/crx_encoder.h"
+#include "../common/fixed_value.h"
+#include "../common/int_text.h"
+
+#define NVALUE 1000000
+#define NREPEAT 10
+
+struct diff_value {
+    fixed_t y;
+    int  ndigit;                /* number of the lower digits (5: data, 8: clock) */
+};
+
+/*---------------------------------------------------------------------*/
+static double now(void) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+/*---------------------------------------------------------------------*/
+static unsigned long next_rand(unsigned long* state) {
+    *state = *state * 6364136223846793005UL + 1442695040888963407UL;
+    return *state >> 17;
+}
+/*---------------------------------------------------------------------*/
+static void make_values(std::vector<diff_value>& v) {
+    /**** mostly small 3rd order differences, some arc initializations ****/
+    /**** (large values) and some clock values with 8 lower digits     ****/
+    unsigned long state = 12345;
+    long r, scale, base, u, l;
+    size_t i;
+
+    v.resize(NVALUE);
+    for (i = 0; i < v.size(); i++) {
+        r = (long)(next_rand(&state) % 100);
+        v[i].ndigit = 5;
+        scale = (r < 70) ? 1000 : (r < 95) ? 100000 : 100000000;
+        if (r >= 98) {
+            v[i].ndigit = 8;
+            scale = 1000000000;
+        }
+        base = (v[i].ndigit == 5) ? 100000 : 100000000;
+        r = (long)(next_rand(&state) % (unsigned long)(2 * scale + 1)) - scale;
+        u = r / base;
+        l = r % base;
+        if (next_rand(&state) % 2) u *= 12345;  /* values of an arc initialization */
+        v[i].y = (fixed_t)u * base + l;
+    }
+}
+/*---------------------------------------------------------------------*/
+static size_t format_sprintf(const std::vector<diff_value>& v, char* buff) {
+    char* p = buff;
+    long u, l;
+    size_t i;
+
+    for (i = 0; i < v.size(); i++) {
+        if (v[i].ndigit == 5) {
+            u = (long)(v[i].y / 100000); l = (long)(v[i].y % 100000);
+        }
+        else {
+            u = (long)(v[i].y / 100000000); l = (long)(v[i].y % 100000000);
+        }
+        if (u == 0) p += sprintf(p, "%ld", l);
+        else if (v[i].ndigit == 5) p += sprintf(p, "%ld%5.5ld", u, labs(l));
+        else p += sprintf(p, "%ld%8.8ld", u, labs(l));
+        *p++ = ' ';
+    }
+    return (size_t)(p - buff);
+}
+/*---------------------------------------------------------------------*/
+static size_t format_table(const std::vector<diff_value>& v, char* buff) {
+    char* p = buff;
+    size_t i;
+
+    for (i = 0; i < v.size(); i++) {
+        p = put_llong(p, v[i].y);
+        *p++ = ' ';
+    }
+    return (size_t)(p - buff);
+}
+/*---------------------------------------------------------------------*/
+static double bench_format(size_t (*format)(const std::vector<diff_value>&, char*),
+                           const std::vector<diff_value>& v, char* buff, size_t* len) {
+    double t, best = 1e30;
+    int n;
+
+    for (n = 0; n < NREPEAT; n++) {
+        t = now();
+        *len = format(v, buff);
+        t = now() - t;
+        if (t < best) best = t;
+    }
+    return best;
+}
+/*---------------------------------------------------------------------*/
+static int bench_encoder(const char* file) {
+    crx_encoder encoder;
+    FILE* ifp, * ofp;
+    double t;
+    long in_size, out_size;
+    int rc;
+
+    if ((ifp = fopen(file, "rb")) == NULL) {
+        fprintf(stderr, "ERROR : can't open %s\n", file);
+        return 1;
+    }
+    if ((ofp = tmpfile()) == NULL) {
+        fprintf(stderr, "ERROR : can't open a temporary file\n");
+        fclose(ifp);
+        return 1;
+    }
+    fseek(ifp, 0, SEEK_END);
+    in_size = ftell(ifp);
+    rewind(ifp);
+
+    t = now();
+    rc = encoder.convert(ifp, ofp);
+    fflush(ofp);
+    t = now() - t;
+    out_size = ftell(ofp);
+    fclose(ifp);
+    fclose(ofp);
+    if (rc == EXIT_FAILURE) {
+        encoder.print_error(stderr);
+        return 1;
+    }
+    printf("%-30s %8.1f MB/s input  %8.1f MB/s output  (%ld -> %ld bytes)\n",
+           file, in_size / t / 1e6, out_size / t / 1e6, in_size, out_size);
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+int main(int argc, char* argv[]) {
+    std::vector<diff_value> v;
+    std::vector<char> buff1, buff2;
+    size_t len1, len2;
+    double t1, t2;
+    int i, rc = 0;
+
+    make_values(v);
+    buff1.resize(v.size() * 24);
+    buff2.resize(v.size() * 24);
+    t1 = bench_format(format_sprintf, v, &buff1[0], &len1);
+    t2 = bench_format(format_table, v, &buff2[0], &len2);
+    if (len1 != len2 || memcmp(&buff1[0], &buff2[0], len1) != 0) {
+        fprintf(stderr, "ERROR : put_llong() differs from sprintf()\n");
+        return 1;
+    }
+    printf("%d values, %lu bytes of text\n", NVALUE, (unsigned long)len1);
+    printf("  sprintf()          : %8.1f MB/s\n", len1 / t1 / 1e6);
+    printf("  put_llong()        : %8.1f MB/s  (x%.2f)\n", len2 / t2 / 1e6, t1 / t2);
+
+    for (i = 1; i < argc; i++) rc |= bench_encoder(argv[i]);
+    return rc;
+}
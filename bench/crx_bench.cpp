@@ -0,0 +1,164 @@
+/****************************************************************************/
+/*     crx_bench.cpp : speed of RNX2CRX and CRX2RNX on synthetic files      */
+/*                                                                          */
+/*     Usage: crx_bench [-V 2|3|4] [-S systems] [-n #] [-t #] [-i sec]      */
+/*                      [-e #] [-k rate] [-b rate] [-s seed] [-r #] [-J #]  */
+/*                      [-o file] [-h]                                      */
+/*                                                                          */
+/*     Makes a RINEX observation file by gen_rinex() (see rnx_gen.h),       */
+/*     compresses it and recovers it in the same process, and reports the  */
+/*     speed of each in MB/s (of the RINEX file) and in epochs/s. The best  */
+/*     of "-r" runs is taken. The files are temporary files (normally in    */
+/*     the page cache), so the speed is mostly that of the conversion.      */
+/*     The recovered file is checked to be identical to the generated one. */
+/*     The same parameters always give the same file, so the results of    */
+/*     two builds can be compared.                                          */
+/*                                                                          */
+/*     Build: see CMakeLists.txt in the top directory (target crx_bench).   */
+/****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+
+#include "bench_codec.h"
+#include "rnx_gen.h"
+
+#define DEFAULT_REPEAT 5
+
+/*---------------------------------------------------------------------*/
+static double now(void) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+/*---------------------------------------------------------------------*/
+static void usage(const char* progname) {
+    gen_param p;
+
+    gen_default(&p);
+    fprintf(stderr, "Usage: %s [-V 2|3|4] [-S systems] [-n #] [-t #] [-i sec] [-e #] [-k rate] [-b rate]\n"
+        "        [-s seed] [-r #] [-J #] [-o file] [-h]\n", progname);
+    fprintf(stderr, "    -V #      : RINEX version (default: %d)\n", p.version);
+    fprintf(stderr, "    -S sys    : GNSS systems out of GRECJSI (RINEX 2: GRES, default: %s)\n", p.systems);
+    fprintf(stderr, "    -n #      : satellites of each system, 1-32 (default: %d)\n", p.nsat);
+    fprintf(stderr, "                (about 60%% of them are observed at an epoch)\n");
+    fprintf(stderr, "    -t #      : observation types of each system (default: %d)\n", p.ntype);
+    fprintf(stderr, "                up to 20 (RINEX 2, and the systems G, R, E, C, J), 8 (S, I)\n");
+    fprintf(stderr, "    -i sec    : interval of the epochs (default: %g)\n", p.interval);
+    fprintf(stderr, "    -e #      : number of the epochs (default: %ld)\n", p.nepoch);
+    fprintf(stderr, "    -k rate   : probability of a cycle slip of a phase at an epoch (default: %g)\n", p.slip_rate);
+    fprintf(stderr, "    -b rate   : probability of a blank field (default: %g)\n", p.blank_rate);
+    fprintf(stderr, "    -s seed   : seed of the pseudo-random numbers (default: %llu)\n", p.seed);
+    fprintf(stderr, "    -r #      : number of the runs; the best one is reported (default: %d)\n", DEFAULT_REPEAT);
+    fprintf(stderr, "    -J #      : threads for one file of RNX2CRX and CRX2RNX (default: 1)\n");
+    fprintf(stderr, "    -o file   : only write the generated RINEX file to \"file\"\n");
+    fprintf(stderr, "    -h        : display this message\n");
+    exit(1);
+}
+/*---------------------------------------------------------------------*/
+static int read_file(FILE* fp, std::string* s) {
+    char buff[65536];
+    size_t n;
+
+    s->clear();
+    rewind(fp);
+    while ((n = fread(buff, 1, sizeof(buff), fp)) > 0) s->append(buff, n);
+    return ferror(fp) ? -1 : 0;
+}
+/*---------------------------------------------------------------------*/
+static double run(int (*convert)(FILE*, FILE*, int), FILE* in, FILE** out, int nthread, int repeat, int* rc) {
+    /**** best time of "repeat" conversions. *out : output of the last one ****/
+    double t, best = 1e30;
+    int n;
+
+    *out = NULL;
+    for (n = 0; n < repeat; n++) {
+        if (*out != NULL) fclose(*out);
+        if ((*out = tmpfile()) == NULL) {
+            fprintf(stderr, "ERROR : can't open a temporary file\n");
+            *rc = 1;
+            return 0.0;
+        }
+        rewind(in);
+        t = now();
+        *rc = convert(in, *out, nthread);
+        fflush(*out);
+        t = now() - t;
+        if (*rc == EXIT_FAILURE) return 0.0;
+        if (t < best) best = t;
+    }
+    return best;
+}
+/*---------------------------------------------------------------------*/
+int main(int argc, char* argv[]) {
+    gen_param p;
+    std::string rnx, recovered;
+    const char* progname = argv[0], * outfile = NULL;
+    FILE* fp, * crx, * out;
+    double t_gen, t_enc, t_dec, mb;
+    long nepoch, crx_size;
+    int repeat = DEFAULT_REPEAT, nthread = 1, rc;
+
+    gen_default(&p);
+    for (argc--, argv++; argc > 0; argc--, argv++) {
+        if (argc < 2 || (*argv)[0] != '-' || strlen(*argv) != 2) usage(progname);
+        switch ((*argv)[1]) {
+        case 'V': p.version = atoi(argv[1]); break;
+        case 'S': p.systems = argv[1]; break;
+        case 'n': p.nsat = atoi(argv[1]); break;
+        case 't': p.ntype = atoi(argv[1]); break;
+        case 'i': p.interval = atof(argv[1]); break;
+        case 'e': p.nepoch = atol(argv[1]); break;
+        case 'k': p.slip_rate = atof(argv[1]); break;
+        case 'b': p.blank_rate = atof(argv[1]); break;
+        case 's': p.seed = strtoull(argv[1], NULL, 10); break;
+        case 'r': if ((repeat = atoi(argv[1])) < 1) usage(progname); break;
+        case 'J': if ((nthread = atoi(argv[1])) < 1) usage(progname); break;
+        case 'o': outfile = argv[1]; break;
+        default: usage(progname);
+        }
+        argc--; argv++;
+    }
+
+    t_gen = now();
+    if ((nepoch = gen_rinex(&p, &rnx)) < 0) {
+        fprintf(stderr, "ERROR : invalid parameters of the file\n");
+        usage(progname);
+    }
+    t_gen = now() - t_gen;
+    if ((fp = (outfile != NULL) ? fopen(outfile, "wb") : tmpfile()) == NULL
+        || fwrite(rnx.data(), 1, rnx.size(), fp) != rnx.size() || fflush(fp) != 0) {
+        fprintf(stderr, "ERROR : can't write %s\n", (outfile != NULL) ? outfile : "a temporary file");
+        return 1;
+    }
+    if (outfile != NULL) {
+        fclose(fp);
+        return 0;
+    }
+
+    mb = (double)rnx.size() / 1e6;
+    printf("RINEX %s, systems %s, %d satellites of each system, %d types, %g s, slip %g, blank %g, seed %llu\n",
+        (p.version == 2) ? "2.11" : (p.version == 3) ? "3.05" : "4.01", p.systems, p.nsat, p.ntype,
+        p.interval, p.slip_rate, p.blank_rate, p.seed);
+    printf("%ld epochs, RINEX %.2f MB (generated in %.1f s)\n", nepoch, mb, t_gen);
+
+    t_enc = run(bench_compress, fp, &crx, nthread, repeat, &rc);
+    if (rc == EXIT_FAILURE) return 1;
+    crx_size = ftell(crx);
+    t_dec = run(bench_decompress, crx, &out, nthread, repeat, &rc);
+    if (rc == EXIT_FAILURE) return 1;
+
+    printf("Compact RINEX %.2f MB (%.1f%% of RINEX)\n", (double)crx_size / 1e6, 100.0 * (double)crx_size / (double)rnx.size());
+    printf("compression   : %8.1f MB/s  %10.0f epochs/s  (%.1f ms, best of %d)\n",
+        mb / t_enc, (double)nepoch / t_enc, t_enc * 1e3, repeat);
+    printf("decompression : %8.1f MB/s  %10.0f epochs/s  (%.1f ms, best of %d)\n",
+        mb / t_dec, (double)nepoch / t_dec, t_dec * 1e3, repeat);
+
+    rc = (read_file(out, &recovered) == 0 && recovered == rnx) ? 0 : 1;
+    printf("round trip    : %s\n", (rc == 0) ? "identical" : "DIFFERENT");
+    fclose(fp);
+    fclose(crx);
+    fclose(out);
+    return rc;
+}
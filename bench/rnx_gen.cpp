@@ -0,0 +1,346 @@
+/****************************************************************************/
+/*     rnx_gen.cpp : synthetic RINEX observation files for the benchmarks   */
+/****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+
+#include "rnx_gen.h"
+
+#define SPEED_OF_LIGHT 299792458.0
+#define ORBIT_PERIOD   43082.0      /* half a sidereal day (s) */
+#define PI             3.14159265358979
+#define MAX_BAND       5
+#define MAX_PRN        32
+#define MAXCLM         512          /* longest line written */
+
+struct band_def {
+    const char* code;           /* band and attribute (RINEX 3/4), band (RINEX 2) */
+    double freq;                /* Hz */
+};
+struct system_def {
+    char sys;
+    int  nband;
+    band_def band[MAX_BAND];
+};
+
+/**** bands of each system, in the order they are used ****/
+static const system_def systems_v3[] = {
+    { 'G', 5, { { "1C", 1575.42e6 }, { "2W", 1227.60e6 }, { "5Q", 1176.45e6 }, { "1L", 1575.42e6 }, { "2L", 1227.60e6 } } },
+    { 'R', 5, { { "1C", 1602.00e6 }, { "2C", 1246.00e6 }, { "1P", 1602.00e6 }, { "2P", 1246.00e6 }, { "3Q", 1202.025e6 } } },
+    { 'E', 5, { { "1C", 1575.42e6 }, { "5Q", 1176.45e6 }, { "7Q", 1207.14e6 }, { "8Q", 1191.795e6 }, { "6C", 1278.75e6 } } },
+    { 'C', 5, { { "2I", 1561.098e6 }, { "7I", 1207.14e6 }, { "6I", 1268.52e6 }, { "1P", 1575.42e6 }, { "5P", 1176.45e6 } } },
+    { 'J', 5, { { "1C", 1575.42e6 }, { "2L", 1227.60e6 }, { "5Q", 1176.45e6 }, { "1L", 1575.42e6 }, { "6Z", 1278.75e6 } } },
+    { 'S', 2, { { "1C", 1575.42e6 }, { "5I", 1176.45e6 } } },
+    { 'I', 2, { { "5A", 1176.45e6 }, { "9A", 2492.028e6 } } },
+};
+/**** RINEX 2 : one list of the types for all the systems ****/
+static const band_def bands_v2[MAX_BAND] = {
+    { "1", 1575.42e6 }, { "2", 1227.60e6 }, { "5", 1176.45e6 }, { "7", 1207.14e6 }, { "8", 1191.795e6 }
+};
+static const char kinds[] = "CLDS";     /* types of a band, in this order */
+
+struct sat_state {
+    char sys;
+    int  prn;
+    int  visible;               /* observed at the previous epoch */
+    double r0, amp, phase;      /* range = r0 - amp * elevation */
+    double bias[MAX_BAND];      /* of the pseudorange (m) */
+    double amb[MAX_BAND];       /* ambiguity of the phase (cycles) */
+};
+
+/*---------------------------------------------------------------------*/
+static double uniform(unsigned long long* state) {
+    /**** [0,1) from xorshift64* ****/
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return (double)((*state * 2685821657736338717ULL) >> 11) / 9007199254740992.0;
+}
+/*---------------------------------------------------------------------*/
+static double noise(unsigned long long* state) {
+    /**** about N(0,1) ****/
+    return (uniform(state) + uniform(state) + uniform(state) - 1.5) * 2.0;
+}
+/*---------------------------------------------------------------------*/
+static const system_def* find_system(char sys) {
+    size_t i;
+
+    for (i = 0; i < sizeof(systems_v3) / sizeof(systems_v3[0]); i++) {
+        if (systems_v3[i].sys == sys) return &systems_v3[i];
+    }
+    return NULL;
+}
+/*---------------------------------------------------------------------*/
+static void put_line(std::string* out, const char* line) {
+    /**** without the trailing blanks ****/
+    size_t n = strlen(line);
+
+    while (n > 0 && line[n - 1] == ' ') n--;
+    out->append(line, n);
+    out->push_back('\n');
+}
+/*---------------------------------------------------------------------*/
+static void put_header(std::string* out, const char* text, const char* label) {
+    char line[MAXCLM];
+
+    snprintf(line, sizeof(line), "%-60.60s%s", text, label);
+    put_line(out, line);
+}
+/*---------------------------------------------------------------------*/
+static void epoch_date(long long t, int* date, double* sec) {
+    /**** t : 1e-7 s from 2022-01-01 00:00:00. date : y, m, d, h, m ****/
+    static const int mdays[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    long long s = t / 10000000;
+    long day = (long)(s / 86400);
+    int y = 2022, m = 0, n;
+
+    for (;;) {
+        n = mdays[m] + (m == 1 && y % 4 == 0);
+        if (day < n) break;
+        day -= n;
+        if (++m == 12) { m = 0; y++; }
+    }
+    s %= 86400;
+    date[0] = y;
+    date[1] = m + 1;
+    date[2] = (int)day + 1;
+    date[3] = (int)(s / 3600);
+    date[4] = (int)(s % 3600 / 60);
+    *sec = (double)(s % 60) + (double)(t % 10000000) * 1e-7;
+}
+/*---------------------------------------------------------------------*/
+static const band_def* band_of(const gen_param* p, char sys, int j) {
+    return (p->version == 2) ? &bands_v2[j / 4] : &find_system(sys)->band[j / 4];
+}
+/*---------------------------------------------------------------------*/
+static void type_code(const gen_param* p, char sys, int j, char* code) {
+    const band_def* b = band_of(p, sys, j);
+
+    if (p->version == 2) sprintf(code, "%c%s", (j == 4) ? 'P' : kinds[j % 4], b->code);   /** P2 **/
+    else sprintf(code, "%c%s", kinds[j % 4], b->code);
+}
+/*---------------------------------------------------------------------*/
+void gen_default(gen_param* p) {
+    p->version = 3;
+    p->systems = "GREC";
+    p->nsat = 24;
+    p->ntype = 8;
+    p->interval = 30.0;
+    p->nepoch = 2880;
+    p->slip_rate = 0.001;
+    p->blank_rate = 0.05;
+    p->seed = 1;
+}
+/*---------------------------------------------------------------------*/
+int  gen_max_types(const gen_param* p) {
+    const system_def* s;
+    const char* c;
+    int n = MAX_BAND * 4;
+
+    if (p->version == 2) return n;
+    for (c = p->systems; *c != '\0'; c++) {
+        if ((s = find_system(*c)) != NULL && s->nband * 4 < n) n = s->nband * 4;
+    }
+    return n;
+}
+/*---------------------------------------------------------------------*/
+static void header(const gen_param* p, std::string* out) {
+    char text[MAXCLM], code[4];
+    const char* c;
+    double sec;
+    int date[5], j, nsys = (int)strlen(p->systems);
+
+    sprintf(text, "%9.2f%11s%-20s%c", (p->version == 2) ? 2.11 : (p->version == 3) ? 3.05 : 4.01, "",
+        "OBSERVATION DATA", (nsys == 1) ? p->systems[0] : 'M');
+    put_header(out, text, "RINEX VERSION / TYPE");
+    sprintf(text, "%-20s%-20s%-20s", "crx_bench", "RNXCMP", "20220101 000000 UTC");
+    put_header(out, text, "PGM / RUN BY / DATE");
+    put_header(out, "SYNT", "MARKER NAME");
+    put_header(out, "SYNTHETIC DATA", "OBSERVER / AGENCY");
+    sprintf(text, "%14.4f%14.4f%14.4f", -3957199.2, 3310199.7, 3737711.7);
+    put_header(out, text, "APPROX POSITION XYZ");
+    if (p->version == 2) {
+        put_header(out, "     1     1", "WAVELENGTH FACT L1/2");
+        sprintf(text, "%6d", p->ntype);
+        for (j = 0; j < p->ntype; j++) {
+            if (j > 0 && j % 9 == 0) {
+                put_header(out, text, "# / TYPES OF OBSERV");
+                sprintf(text, "%6s", "");
+            }
+            type_code(p, 'G', j, code);
+            sprintf(text + strlen(text), "%6s", code);
+        }
+        put_header(out, text, "# / TYPES OF OBSERV");
+    }
+    else {
+        for (c = p->systems; *c != '\0'; c++) {
+            sprintf(text, "%c  %3d", *c, p->ntype);
+            for (j = 0; j < p->ntype; j++) {
+                if (j > 0 && j % 13 == 0) {
+                    put_header(out, text, "SYS / # / OBS TYPES");
+                    sprintf(text, "%6s", "");
+                }
+                type_code(p, *c, j, code);
+                sprintf(text + strlen(text), " %s", code);
+            }
+            put_header(out, text, "SYS / # / OBS TYPES");
+        }
+    }
+    sprintf(text, "%10.3f", p->interval);
+    put_header(out, text, "INTERVAL");
+    epoch_date(0, date, &sec);
+    sprintf(text, "%6d%6d%6d%6d%6d%13.7f     GPS", date[0], date[1], date[2], date[3], date[4], sec);
+    put_header(out, text, "TIME OF FIRST OBS");
+    put_header(out, "", "END OF HEADER");
+}
+/*---------------------------------------------------------------------*/
+static void field(const gen_param* p, sat_state* s, int j, double elev, double rate,
+                  unsigned long long* state, char* q) {
+    /**** the j-th type of a satellite (16 columns) ****/
+    const band_def* b = band_of(p, s->sys, j);
+    double lambda = SPEED_OF_LIGHT / b->freq, range = s->r0 - s->amp * elev, v, snr;
+    char lli = ' ', ssi = ' ';
+    int k = j / 4;
+
+    snr = 30.0 + 18.0 * ((elev > 0.0) ? elev : 0.0) + noise(state);
+    switch (kinds[j % 4]) {
+    case 'C':
+        v = range + s->bias[k] + 0.3 * noise(state);
+        ssi = (char)('0' + ((snr / 6 < 1) ? 1 : (snr / 6 > 9) ? 9 : (int)(snr / 6)));
+        break;
+    case 'L':
+        if (uniform(state) < p->slip_rate) {
+            s->amb[k] += (double)(1 + (int)(uniform(state) * 50)) * ((uniform(state) < 0.5) ? -1 : 1);
+            lli = '1';
+        }
+        v = range / lambda + s->amb[k] + 0.002 * noise(state);
+        ssi = (char)('0' + ((snr / 6 < 1) ? 1 : (snr / 6 > 9) ? 9 : (int)(snr / 6)));
+        break;
+    case 'D':
+        v = -rate / lambda + 0.05 * noise(state);
+        break;
+    default:
+        v = snr;
+        break;
+    }
+    if (uniform(state) < p->blank_rate) {
+        sprintf(q, "%16s", "");
+        return;
+    }
+    sprintf(q, "%14.3f%c%c", v, lli, ssi);
+    if (q[9] == '0' && (q[8] == ' ' || q[8] == '-')) {    /** as CRX2RNX: "  .123", " -.123" **/
+        if (q[8] == '-' && strncmp(q + 11, "000", 3) == 0) q[8] = ' ';   /** -0.000 **/
+        q[9] = q[8];
+        q[8] = ' ';
+    }
+}
+/*---------------------------------------------------------------------*/
+long gen_rinex(const gen_param* p, std::string* out) {
+    std::vector<sat_state> sat;
+    std::vector<int> list;
+    unsigned long long state = p->seed * 0x9E3779B97F4A7C15ULL + 1;
+    char line[MAXCLM], text[MAXCLM];
+    const char* c;
+    double sec, w = 2 * PI / ORBIT_PERIOD, a, elev, rate;
+    long long t;
+    long k, nepoch = 0;
+    size_t i, n;
+    int date[5], j, m, nband;
+
+    /**** check the parameters ****/
+    if (p->version < 2 || p->version > 4 || p->nsat < 1 || p->nsat > MAX_PRN || p->ntype < 1
+        || p->interval <= 0.0 || p->nepoch < 1 || p->slip_rate < 0.0 || p->blank_rate < 0.0
+        || *p->systems == '\0') return -1;
+    for (c = p->systems; *c != '\0'; c++) {
+        if (find_system(*c) == NULL || strchr(c + 1, *c) != NULL) return -1;
+        if (p->version == 2 && strchr("GRES", *c) == NULL) return -1;
+    }
+    if (p->ntype > gen_max_types(p)) return -1;
+
+    /**** satellites ****/
+    for (c = p->systems; *c != '\0'; c++) {
+        for (j = 1; j <= p->nsat; j++) {
+            sat_state s;
+            s.sys = *c;
+            s.prn = (*c == 'S') ? j + 19 : j;
+            s.visible = 0;
+            s.r0 = 2.3e7 + 4.0e6 * uniform(&state);
+            s.amp = 3.0e6;
+            s.phase = 2 * PI * uniform(&state);
+            for (m = 0; m < MAX_BAND; m++) {
+                s.bias[m] = 10.0 * noise(&state);
+                s.amb[m] = 0.0;
+            }
+            sat.push_back(s);
+        }
+    }
+    nband = (p->ntype + 3) / 4;
+
+    out->clear();
+    header(p, out);
+    for (k = 0; k < p->nepoch; k++) {
+        t = (long long)floor(p->interval * 1e7 * (double)k + 0.5);
+        list.clear();
+        for (i = 0; i < sat.size(); i++) {
+            elev = sin(w * (double)t * 1e-7 + sat[i].phase);
+            if (elev < -0.2) {
+                sat[i].visible = 0;
+                continue;
+            }
+            if (!sat[i].visible) {  /** a new arc **/
+                for (m = 0; m < nband; m++) sat[i].amb[m] = floor(2.0e6 * noise(&state));
+                sat[i].visible = 1;
+            }
+            list.push_back((int)i);
+        }
+        if (list.empty()) continue;
+
+        /**** epoch line ****/
+        epoch_date(t, date, &sec);
+        if (p->version == 2) {
+            n = (size_t)sprintf(line, " %02d %2d %2d %2d %2d%11.7f  0%3d", date[0] % 100, date[1], date[2],
+                date[3], date[4], sec, (int)list.size());
+            for (i = 0; i < list.size(); i++) {
+                if (i > 0 && i % 12 == 0) {
+                    put_line(out, line);
+                    n = (size_t)sprintf(line, "%32s", "");
+                }
+                n += (size_t)sprintf(line + n, "%c%02d", sat[list[i]].sys, sat[list[i]].prn);
+            }
+            put_line(out, line);
+        }
+        else {
+            sprintf(line, "> %4d %02d %02d %02d %02d%11.7f  0%3d", date[0], date[1], date[2],
+                date[3], date[4], sec, (int)list.size());
+            put_line(out, line);
+        }
+
+        /**** data ****/
+        for (i = 0; i < list.size(); i++) {
+            sat_state* s = &sat[list[i]];
+            a = w * (double)t * 1e-7 + s->phase;
+            elev = sin(a);
+            rate = -s->amp * w * cos(a);
+            if (p->version == 2) {
+                for (j = 0; j < p->ntype; j++) {
+                    field(p, s, j, elev, rate, &state, text + (j % 5) * 16);
+                    if (j % 5 == 4 || j == p->ntype - 1) put_line(out, text);
+                }
+            }
+            else {
+                n = (size_t)sprintf(line, "%c%02d", s->sys, s->prn);
+                for (j = 0; j < p->ntype; j++) {
+                    field(p, s, j, elev, rate, &state, line + n);
+                    n += 16;
+                }
+                put_line(out, line);
+            }
+        }
+        nepoch++;
+    }
+    return nepoch;
+}
@@ -0,0 +1,41 @@
+/****************************************************************************/
+/*     rnx_gen.h : synthetic RINEX observation files for the benchmarks     */
+/*                                                                          */
+/*     gen_rinex() writes a RINEX 2.11, 3.05 or 4.01 observation file made  */
+/*     from a pseudo-random sequence, so that the same parameters always    */
+/*     give the same file. Each satellite has a smooth range (a sine of     */
+/*     half a sidereal day), from which the pseudorange, the phase, the     */
+/*     Doppler and the signal strength of every band are derived with a    */
+/*     small noise. A satellite is observed while its "elevation" is above  */
+/*     a threshold, so satellites appear and disappear during a long file. */
+/*     At a cycle slip the ambiguity of the phase jumps and the LLI is set. */
+/*     A field is left blank with the probability blank_rate.              */
+/*                                                                          */
+/*     The lines are written without trailing blanks, as CRX2RNX recovers   */
+/*     them, and without the receiver clock offset; the file recovered      */
+/*     from its Compact RINEX is then identical to it.                      */
+/****************************************************************************/
+#ifndef RNX_GEN_H
+#define RNX_GEN_H
+
+#include <string>
+
+struct gen_param {
+    int  version;               /* 2, 3 or 4 */
+    const char* systems;        /* GNSS systems (G, R, E, C, J, S, I; RINEX 2: G, R, E, S) */
+    int  nsat;                  /* satellites of each system (1-32) */
+    int  ntype;                 /* observation types of each system */
+    double interval;            /* seconds between the epochs */
+    long nepoch;                /* number of the epochs */
+    double slip_rate;           /* probability of a cycle slip of a phase at an epoch */
+    double blank_rate;          /* probability of a blank field */
+    unsigned long long seed;
+};
+
+void gen_default(gen_param* p);
+int  gen_max_types(const gen_param* p);     /* largest ntype for the version and systems */
+
+/**** returns the number of the epochs written, or -1 for invalid parameters ****/
+long gen_rinex(const gen_param* p, std::string* out);
+
+#endif
@@ -0,0 +1,68 @@
+/****************************************************************************/
+/*     arc_kernel.h : differences and integration of the data arcs          */
+/*                                                                          */
+/*     The data of one satellite are held in planes: y[k][j] is the k-th    */
+/*     order difference of the j-th data type. One order of the            */
+/*     difference (RNX2CRX) or of the integration (CRX2RNX) is then a loop  */
+/*     over j without dependency between the data types, which the          */
+/*     compiler turns into SIMD instructions (SSE2/AVX2, NEON).             */
+/*                                                                          */
+/*     The loops run over all the data types of the satellite. The caller  */
+/*     treats one by one the fields that are blank, start a new arc or      */
+/*     belong to an arc of another order. As such fields may hold any old   */
+/*     value, the sums are taken in unsigned integers (wrap-around instead  */
+/*     of overflow); the results of those fields are simply not used.      */
+/****************************************************************************/
+#ifndef ARC_KERNEL_H
+#define ARC_KERNEL_H
+
+#include "fixed_value.h"
+
+/*---------------------------------------------------------------------*/
+inline void plane_sub(fixed_t* __restrict d, const fixed_t* __restrict a,
+                      const fixed_t* __restrict b, int n) {
+    /**** d[j] = a[j] - b[j] ****/
+    int j;
+
+    for (j = 0; j < n; j++) d[j] = (fixed_t)((unsigned long long)a[j] - (unsigned long long)b[j]);
+}
+/*---------------------------------------------------------------------*/
+inline int plane_add(fixed_t* __restrict d, const fixed_t* __restrict a,
+                     const fixed_t* __restrict b, int n) {
+    /**** d[j] = a[j] + b[j]. returns 1 if some d[j] is not in the range  ****/
+    /**** of fixed_in_range(), i.e. fixed_add() would have given another  ****/
+    /**** value. Then d[j]+(LIMIT-1) or (LIMIT-1)-d[j] is negative, so    ****/
+    /**** only the sign bits are collected (no comparison in the loop).   ****/
+    unsigned long long s, out = 0;
+    int j;
+
+    for (j = 0; j < n; j++) {
+        s = (unsigned long long)a[j] + (unsigned long long)b[j];
+        d[j] = (fixed_t)s;
+        out |= (s + (FIXED_LIMIT - 1)) | ((FIXED_LIMIT - 1) - s);
+    }
+    return (int)(out >> 63);
+}
+/*---------------------------------------------------------------------*/
+inline void arc_diff(fixed_t* const* y1, fixed_t* const* y0, int order, int n) {
+    /**** differences of the arcs continued from the previous epoch    ****/
+    /****   y1[k+1][j] = y1[k][j] - y0[k][j]   (k = 0, ..., order-1)    ****/
+    /**** The planes up to the order of each arc are valid for any arc ****/
+    /**** of order <= "order".                                         ****/
+    int k;
+
+    for (k = 0; k < order; k++) plane_sub(y1[k + 1], y1[k], y0[k], n);
+}
+/*---------------------------------------------------------------------*/
+inline int arc_integrate(fixed_t* const* y1, fixed_t* const* y0, int order, int n) {
+    /**** integration of the arcs of full order "order"                ****/
+    /****   y1[k+1][j] = y1[k][j] + y0[k+1][j]  (k = 0, ..., order-1)   ****/
+    /**** y1[order][j] is the data. returns 1 if some sum is out of    ****/
+    /**** range; the caller then repeats them with fixed_add().         ****/
+    int k, out = 0;
+
+    for (k = 0; k < order; k++) out |= plane_add(y1[k + 1], y1[k], y0[k + 1], n);
+    return out;
+}
+
+#endif
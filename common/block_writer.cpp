@@ -0,0 +1,210 @@
+/****************************************************************************/
+/*     block_writer.cpp : output in large blocks                            */
+/****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include "block_writer.h"
+
+#define PRINT_RESERVE 4096      /* room kept for print() before trying vsnprintf() */
+
+/*---------------------------------------------------------------------*/
+static long count_newline(const char* p, size_t n) {
+    const char* e = p + n;
+    long count = 0;
+
+    while (p < e && (p = (const char*)memchr(p, '\n', (size_t)(e - p))) != NULL) {
+        count++;
+        p++;
+    }
+    return count;
+}
+/*---------------------------------------------------------------------*/
+block_writer::block_writer() {
+    fp = NULL;
+    mem = NULL;
+    buff = NULL;
+    size = len = 0;
+    nout = 0;
+    nline = 0;
+    counting = 0;
+    hook = NULL;
+    hook_arg = NULL;
+    queued = spare = NULL;
+    block_mem = NULL;
+    nsent = 0;
+    nwritten = 0;
+}
+/*---------------------------------------------------------------------*/
+block_writer::~block_writer() {
+    close();
+}
+/*---------------------------------------------------------------------*/
+void block_writer::open(FILE* out, size_t block_size, int threaded) {
+    write_block b;
+    int i;
+
+    close();
+    fp = out;
+    nout = 0;
+    nline = 0;
+    counting = 0;
+    if (block_size < MIN_BLOCK_SIZE) block_size = MIN_BLOCK_SIZE;
+    if (block_size > MAX_BLOCK_SIZE) block_size = MAX_BLOCK_SIZE;
+    if (threaded && (block_mem = (char*)malloc(block_size * WRITE_NBLOCK)) != NULL) {
+        queued = new block_ring;
+        spare = new block_ring;
+        for (i = 1; i < WRITE_NBLOCK; i++) {
+            b.p = block_mem + block_size * i;
+            b.n = 0;
+            spare->put(b);
+        }
+        buff = block_mem;
+        size = block_size;
+        nsent = 0;
+        nwritten = 0;
+        writer = std::thread(&block_writer::run, this);
+        return;
+    }
+    if ((buff = (char*)malloc(block_size)) != NULL) size = block_size;  /** else write directly **/
+}
+/*---------------------------------------------------------------------*/
+void block_writer::open_memory(std::string* out, size_t block_size) {
+    open(NULL, block_size);
+    mem = out;
+}
+/*---------------------------------------------------------------------*/
+void block_writer::close(void) {
+    write_block b;
+
+    if (fp != NULL || mem != NULL) flush();
+    if (writer.joinable()) {
+        b.p = NULL;
+        b.n = 0;
+        queued->put(b);
+        writer.join();
+        delete queued;
+        delete spare;
+        queued = spare = NULL;
+        free(block_mem);
+        block_mem = NULL;
+    }
+    else {
+        free(buff);
+    }
+    buff = NULL;
+    size = len = 0;
+    fp = NULL;
+    mem = NULL;
+    hook = NULL;
+}
+/*---------------------------------------------------------------------*/
+void block_writer::put_block(void) {
+    write_block b;
+
+    if (len > 0) {
+        nout += len;
+        if (counting) nline += count_newline(buff, len);
+        if (mem != NULL) {
+            mem->append(buff, len);
+        }
+        else if (queued != NULL) {  /** to the writer thread **/
+            b.p = buff;
+            b.n = len;
+            queued->put(b);
+            nsent++;
+            spare->get(&b);
+            buff = b.p;
+        }
+        else {
+            fwrite(buff, 1, len, fp);
+        }
+    }
+    len = 0;
+}
+/*---------------------------------------------------------------------*/
+void block_writer::drain(void) {
+    /**** wait until the writer thread has written all the blocks ****/
+    int k;
+
+    if (queued == NULL) return;
+    for (k = 0; nwritten.load(std::memory_order_acquire) != nsent; k++) ring_wait(k);
+}
+/*---------------------------------------------------------------------*/
+void block_writer::run(void) {
+    /**** writer thread ****/
+    write_block b;
+
+    for (;;) {
+        queued->get(&b);
+        if (b.p == NULL) return;
+        fwrite(b.p, 1, b.n, fp);
+        nwritten.fetch_add(1, std::memory_order_release);
+        spare->put(b);
+    }
+}
+/*---------------------------------------------------------------------*/
+void block_writer::write(const char* s, size_t n) {
+    if (n == 0) return;
+    if (hook != NULL) hook(hook_arg, s, n);
+    if (n > size - len) {
+        put_block();
+        if (n > size) {               /** larger than the block **/
+            drain();
+            if (mem != NULL) mem->append(s, n);
+            else fwrite(s, 1, n, fp);
+            nout += n;
+            if (counting) nline += count_newline(s, n);
+            return;
+        }
+    }
+    memcpy(buff + len, s, n);
+    len += n;
+}
+/*---------------------------------------------------------------------*/
+void block_writer::print(const char* format, ...) {
+    va_list ap;
+    int n;
+
+    if (size - len < PRINT_RESERVE) put_block();
+    va_start(ap, format);
+    n = (size > 0) ? vsnprintf(buff + len, size - len, format, ap) : -1;
+    va_end(ap);
+    if (n >= 0 && (size_t)n < size - len) {
+        if (hook != NULL) hook(hook_arg, buff + len, (size_t)n);
+        len += (size_t)n;
+        return;
+    }
+    put_block();                      /** does not fit in the block **/
+    drain();
+    va_start(ap, format);
+    if (mem != NULL || hook != NULL) {
+        n = vsnprintf(NULL, 0, format, ap);
+        va_end(ap);
+        if (n <= 0) return;
+        std::string text((size_t)n + 1, '\0');
+        va_start(ap, format);
+        vsnprintf(&text[0], (size_t)n + 1, format, ap);
+        text.resize((size_t)n);
+        if (hook != NULL) hook(hook_arg, text.data(), text.size());
+        if (mem != NULL) mem->append(text);
+        else fwrite(text.data(), 1, text.size(), fp);
+    }
+    else {
+        n = vfprintf(fp, format, ap); /** (the lines are not counted) **/
+    }
+    va_end(ap);
+    if (n > 0) nout += (size_t)n;
+}
+/*---------------------------------------------------------------------*/
+void block_writer::flush(void) {
+    put_block();
+    drain();
+    if (fp != NULL) fflush(fp);
+}
+/*---------------------------------------------------------------------*/
+long block_writer::lines(void) const {
+    return nline + count_newline(buff, len);
+}
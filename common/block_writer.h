@@ -0,0 +1,92 @@
+/****************************************************************************/
+/*     block_writer.h : output in large blocks                              */
+/*                                                                          */
+/*     The text of many epochs is collected in one block of 1-8MB and the   */
+/*     block is passed to fwrite() at once. The length of each piece is     */
+/*     given by the caller, so the text is not scanned again for '\0'.      */
+/*     flush() writes the block immediately, e.g. at every epoch for        */
+/*     real-time use.                                                       */
+/*                                                                          */
+/*     With threaded == 1 (option "-p"), a full block is passed through a   */
+/*     ring to a writer thread, and the text of the next epochs is          */
+/*     collected in another block (WRITE_NBLOCK in all) while it is         */
+/*     written. flush() and the direct writes wait until the writer thread  */
+/*     has written all the blocks passed to it, so the order of the output  */
+/*     is kept.                                                             */
+/*                                                                          */
+/*     open_memory() appends the blocks to a string instead of a file, e.g. */
+/*     for a part of the output made in another thread.                     */
+/*                                                                          */
+/*     tee() passes a copy of every piece of the output, in order, to a     */
+/*     function of the caller (e.g. RNX2CRX "-v" decodes its output again)  */
+/*     as soon as it is given to write() or print(), not when the block is  */
+/*     written, so that the caller can process it while the next epochs     */
+/*     are collected. The function is called in the thread of the caller.   */
+/****************************************************************************/
+#ifndef BLOCK_WRITER_H
+#define BLOCK_WRITER_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "spsc_ring.h"
+
+#define DEFAULT_BLOCK_SIZE 4194304  /* 4MB */
+#define MIN_BLOCK_SIZE     1048576  /* 1MB */
+#define MAX_BLOCK_SIZE     8388608  /* 8MB */
+#define WRITE_NBLOCK       3        /* number of the blocks if threaded */
+
+struct write_block {
+    char* p;                    /* NULL : end of the output */
+    size_t n;
+};
+typedef spsc_ring<write_block, 4> block_ring;
+typedef void (*write_hook)(void* arg, const char* p, size_t n);
+
+class block_writer {
+public:
+    block_writer();
+    ~block_writer();
+
+    void open(FILE* fp, size_t size, int threaded = 0);
+    void open_memory(std::string* out, size_t size);
+    void close(void);                       /* flush and release the block */
+    void write(const char* s, size_t n);
+    void print(const char* format, ...);    /* for the lines other than epochs */
+    void flush(void);                       /* write the block and fflush() */
+    void tee(write_hook fn, void* arg) { hook = fn; hook_arg = arg; }  /* after open() (NULL: none) */
+    unsigned long long tell(void) const { return nout + len; }  /* bytes of the output so far */
+    void count_lines(void) { counting = 1; }  /* count the lines for lines() */
+    long lines(void) const;                 /* lines of the output so far */
+
+private:
+    FILE* fp;
+    std::string* mem;           /* output of open_memory() (then fp == NULL) */
+    char* buff;
+    size_t size, len;           /* size of the block and length of the text in it */
+    unsigned long long nout;    /* bytes passed to fwrite() */
+    long nline;                 /* lines passed to fwrite() (if counting) */
+    int  counting;
+    write_hook hook;            /* copy of the output (tee()) */
+    void* hook_arg;
+
+    /**** writer thread (threaded == 1) ****/
+    std::thread writer;
+    block_ring* queued;         /* blocks to be written, in order */
+    block_ring* spare;          /* blocks written */
+    char* block_mem;
+    size_t nsent;               /* number of the blocks queued */
+    std::atomic<size_t> nwritten;
+
+    void put_block(void);
+    void drain(void);
+    void run(void);
+
+    block_writer(const block_writer&) = delete;
+    block_writer& operator=(const block_writer&) = delete;
+};
+
+#endif
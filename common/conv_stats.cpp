@@ -0,0 +1,93 @@
+/****************************************************************************/
+/*     conv_stats.cpp : time of the phases and counts of one conversion     */
+/****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "conv_stats.h"
+
+/*---------------------------------------------------------------------*/
+conv_stats::conv_stats() {
+    start();
+    wall = 0.0;
+}
+/*---------------------------------------------------------------------*/
+void conv_stats::start(void) {
+    epochs = sats = fields = arc_inits = slips = skipped = 0;
+    memset(bytes, 0, sizeof(bytes));
+    memset(sec, 0, sizeof(sec));
+    memset(tick, 0, sizeof(tick));
+    wall = 0.0;
+    nchunk = 0;
+    current = PHASE_OTHER;
+    t0 = std::chrono::steady_clock::now();
+    first = last = ticks();
+}
+/*---------------------------------------------------------------------*/
+void conv_stats::stop(unsigned long long out_bytes) {
+    /**** the ticks are converted to seconds by the steady_clock over ****/
+    /**** the whole conversion (the time stamp counter of x86 has a    ****/
+    /**** constant rate, but not a known one)                           ****/
+    unsigned long long known = 0;
+    double scale;
+    int k;
+
+    enter(current);
+    wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    scale = (last > first) ? wall / (double)(last - first) : 0.0;
+    for (k = 0; k < NPHASE; k++) sec[k] += (double)tick[k] * scale;
+    for (k = 0; k < BYTES_OTHER; k++) known += bytes[k];
+    bytes[BYTES_OTHER] = (out_bytes > known) ? out_bytes - known : 0;
+}
+/*---------------------------------------------------------------------*/
+void conv_stats::add(const conv_stats& s) {
+    int k;
+
+    epochs += s.epochs;
+    sats += s.sats;
+    fields += s.fields;
+    arc_inits += s.arc_inits;
+    slips += s.slips;
+    skipped += s.skipped;
+    for (k = 0; k < BYTES_OTHER; k++) bytes[k] += s.bytes[k];
+    for (k = 0; k < NPHASE; k++) sec[k] += s.sec[k];
+    nchunk++;
+}
+/*---------------------------------------------------------------------*/
+static double ratio(double a, double b) {
+    return (b > 0.0) ? 100.0 * a / b : 0.0;
+}
+/*---------------------------------------------------------------------*/
+void conv_stats::print(FILE* fp, int encoder) const {
+    static const char* phase_name[NPHASE] = {
+        "other (header, events)", "read lines", "parse", "", "format", "output" };
+    static const char* bytes_name[NBYTES] = {
+        "epoch lines", "clock offsets", "data fields", "flags (LLI, SSI)", "other (header, events)" };
+    double total = 0.0, out = 0.0;
+    int k;
+
+    for (k = 0; k < NPHASE; k++) total += sec[k];
+    for (k = 0; k < NBYTES; k++) out += (double)bytes[k];
+
+    fprintf(fp, "  time %10.3f s", wall);
+    if (nchunk > 0) {
+        fprintf(fp, " (phases: sum of %d %s in the threads, the main thread waits in \"other\")",
+            nchunk, encoder ? "chunks" : "segments");
+    }
+    fprintf(fp, "\n");
+    for (k = PHASE_READ; k <= NPHASE; k++) {     /** "other" at the end **/
+        fprintf(fp, "    %-26s%10.3f s %6.1f%%\n", (k == PHASE_ARC) ? (encoder ? "difference" : "reconstruction")
+            : phase_name[k % NPHASE], sec[k % NPHASE], ratio(sec[k % NPHASE], total));
+    }
+    fprintf(fp, "  epochs                      %12lld\n", epochs);
+    fprintf(fp, "  satellites                  %12lld\n", sats);
+    fprintf(fp, "  data fields                 %12lld\n", fields);
+    fprintf(fp, "  arc initializations         %12lld\n", arc_inits);
+    if (encoder) fprintf(fp, "  cycle slip resets           %12lld\n", slips);
+    fprintf(fp, "  skipped epochs              %12lld\n", skipped);
+    fprintf(fp, "  output %20.0f bytes\n", out);
+    for (k = 0; k < NBYTES; k++) {
+        fprintf(fp, "    %-26s%12llu %6.1f%%\n", bytes_name[k], bytes[k], ratio((double)bytes[k], out));
+    }
+}
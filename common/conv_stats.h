@@ -0,0 +1,92 @@
+/****************************************************************************/
+/*     conv_stats.h : time of the phases and counts of one conversion       */
+/*                                                                          */
+/*     With "--stats", RNX2CRX and CRX2RNX give a conv_stats to the         */
+/*     encoder/decoder, which then calls enter() at the top of each phase   */
+/*     of the conversion: the time since the last call is added to the      */
+/*     phase that is ending. The time is read only there (the time stamp   */
+/*     counter of x86, otherwise steady_clock), so the phases always add   */
+/*     up to the time of the conversion. The encoder and the decoder also  */
+/*     count the epochs, satellites and fields, and add the bytes of their */
+/*     output by category.                                                  */
+/*                                                                          */
+/*     Every call is made only if the pointer to the conv_stats is not      */
+/*     NULL, and the counts are taken at the level of the epochs and the    */
+/*     satellites (or in the branches of the rare cases), so that nothing   */
+/*     is added to the loops over the fields without "--stats".             */
+/****************************************************************************/
+#ifndef CONV_STATS_H
+#define CONV_STATS_H
+
+#include <stdio.h>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define STATS_TSC
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define STATS_TSC
+#endif
+
+enum {
+    PHASE_OTHER,                /* header, event records, skipping, ... */
+    PHASE_READ,                 /* reading the lines (read_chk_line() etc.) */
+    PHASE_PARSE,                /* parsing the lines (ggetline(), getdiff()) */
+    PHASE_ARC,                  /* differencing (RNX2CRX) or reconstruction (CRX2RNX) */
+    PHASE_FORMAT,               /* formatting the output (putdiff(), putfield()) */
+    PHASE_OUTPUT,               /* passing the epochs to the output block and writing it */
+    NPHASE
+};
+
+enum {
+    BYTES_EPOCH,                /* epoch lines (and their continuation lines) */
+    BYTES_CLOCK,                /* receiver clock offsets */
+    BYTES_DATA,                 /* data fields (and satellite IDs, separators) */
+    BYTES_FLAGS,                /* LLI and signal strength */
+    BYTES_OTHER,                /* header, event records, comments */
+    NBYTES
+};
+
+class conv_stats {
+public:
+    conv_stats();
+
+    void start(void);                           /* clears all, phase = PHASE_OTHER */
+    void enter(int phase) {
+        long long t = ticks();
+        tick[current] += t - last;
+        last = t;
+        current = phase;
+    }
+    void stop(unsigned long long out_bytes);    /* out_bytes: whole output (for BYTES_OTHER) */
+    void add(const conv_stats& s);              /* counts and times of a chunk (-J) */
+    void print(FILE* fp, int encoder) const;    /* encoder=1: RNX2CRX, 0: CRX2RNX */
+
+    long long epochs;           /* epochs converted */
+    long long sats;             /* satellite records */
+    long long fields;           /* non-blank data fields */
+    long long arc_inits;        /* data arcs initialized (not by cycle slips) */
+    long long slips;            /* data arcs initialized by large cycle slips (RNX2CRX) */
+    long long skipped;          /* strange epochs skipped (-s) */
+    unsigned long long bytes[NBYTES];
+    double sec[NPHASE];         /* time of each phase (added by stop() and add()) */
+    double wall;                /* time from start() to stop() */
+    int  nchunk;                /* chunks or segments added by add() (-J) */
+
+private:
+    long long tick[NPHASE], first, last;
+    int  current;
+    std::chrono::steady_clock::time_point t0;
+
+    static long long ticks(void) {
+#if defined(STATS_TSC)
+        return (long long)__rdtsc();
+#else
+        return (long long)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+};
+
+#endif
@@ -0,0 +1,124 @@
+/****************************************************************************/
+/*     crx_index.cpp : index of the initialized epochs                      */
+/****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+#include "crx_index.h"
+
+#ifdef _WIN32
+#define ftell_64 _ftelli64
+#define fseek_64 _fseeki64
+#else
+#define ftell_64 ftello
+#define fseek_64 fseeko
+#endif
+
+#define INDEX_ID "CRX INDEX 1"
+
+/*---------------------------------------------------------------------*/
+static int file_size(const char* filename, unsigned long long* size) {
+    FILE* fp;
+    long long n;
+
+    if ((fp = fopen(filename, "rb")) == NULL) return -1;
+    n = (fseek_64(fp, 0, SEEK_END) == 0) ? (long long)ftell_64(fp) : -1;
+    fclose(fp);
+    if (n < 0) return -1;
+    *size = (unsigned long long)n;
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+int    read_epoch_time(const char* line, epoch_time* t) {
+    /**** RINEX 2 : " yy mm dd hh mm ss.sssssss"       ****/
+    /**** RINEX 3/4 : "> yyyy mm dd hh mm ss.sssssss" ****/
+    if (*line == '>' || *line == '&') line++;
+    if (sscanf(line, "%d%d%d%d%d%lf", &t->year, &t->month, &t->day,
+        &t->hour, &t->minute, &t->sec) != 6) return -1;
+    if (t->year < 100) t->year += (t->year < 80) ? 2000 : 1900;
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+int    parse_time(const char* s, epoch_time* t) {
+    int n;
+
+    t->sec = 0.0;
+    n = sscanf(s, "%d-%d-%dT%d:%d:%lf", &t->year, &t->month, &t->day, &t->hour, &t->minute, &t->sec);
+    if (n < 5 || t->month < 1 || t->month > 12 || t->day < 1 || t->day > 31 ||
+        t->hour < 0 || t->hour > 24 || t->minute < 0 || t->minute > 59) return -1;
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+double time_key(const epoch_time* t) {
+    return ((((t->year * 13.0 + t->month) * 32.0 + t->day) * 25.0 + t->hour) * 60.0 + t->minute) * 61.0 + t->sec;
+}
+/*---------------------------------------------------------------------*/
+void crx_index::add(unsigned long long offset, long line, const epoch_time* t) {
+    index_entry e;
+
+    /**** keep the entries in the order of the time for find() ****/
+    if (!entry.empty() && time_key(t) <= time_key(&entry.back().time)) return;
+    e.offset = offset;
+    e.line = line;
+    e.time = *t;
+    entry.push_back(e);
+}
+/*---------------------------------------------------------------------*/
+int  crx_index::write(const char* crx_file) const {
+    FILE* fp;
+    size_t i;
+    const epoch_time* t;
+
+    if ((fp = fopen((std::string(crx_file) + INDEX_SUFFIX).c_str(), "w")) == NULL) return -1;
+    fprintf(fp, "%s %llu\n", INDEX_ID, size);
+    for (i = 0; i < entry.size(); i++) {
+        t = &entry[i].time;
+        fprintf(fp, "%llu %ld %04d %02d %02d %02d %02d %10.7f\n", entry[i].offset, entry[i].line,
+            t->year, t->month, t->day, t->hour, t->minute, t->sec);
+    }
+    return (fclose(fp) == 0) ? 0 : -1;
+}
+/*---------------------------------------------------------------------*/
+int  crx_index::read(const char* crx_file) {
+    FILE* fp;
+    char line[128];
+    unsigned long long crx_size;
+    index_entry e;
+    epoch_time* t = &e.time;
+
+    entry.clear();
+    size = 0;
+    if ((fp = fopen((std::string(crx_file) + INDEX_SUFFIX).c_str(), "r")) == NULL) return -1;
+    if (fgets(line, sizeof(line), fp) == NULL || strncmp(line, INDEX_ID " ", strlen(INDEX_ID) + 1) != 0
+        || sscanf(line + strlen(INDEX_ID), "%llu", &size) != 1) {
+        fclose(fp);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if (sscanf(line, "%llu%ld%d%d%d%d%d%lf", &e.offset, &e.line, &t->year, &t->month, &t->day,
+            &t->hour, &t->minute, &t->sec) != 8) break;
+        entry.push_back(e);
+    }
+    fclose(fp);
+    if (file_size(crx_file, &crx_size) != 0 || crx_size != size) {   /** made for another file **/
+        entry.clear();
+        return -1;
+    }
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+const index_entry* crx_index::find(const epoch_time* t) const {
+    /**** the entries are in the order of the time. An entry at t itself ****/
+    /**** is not taken, as event records at t may be just before it.     ****/
+    double key = time_key(t);
+    size_t lo = 0, hi = entry.size(), mid;
+
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        if (time_key(&entry[mid].time) < key) lo = mid + 1;
+        else hi = mid;
+    }
+    return (lo > 0) ? &entry[lo - 1] : NULL;
+}
@@ -0,0 +1,61 @@
+/****************************************************************************/
+/*     crx_index.h : index of the initialized epochs of Compact RINEX files */
+/*                                                                          */
+/*     A Compact RINEX file can be recovered only from an epoch where all   */
+/*     the data arcs are initialized: the first epoch, every # epochs with  */
+/*     "RNX2CRX -e #", and the epochs after event records. RNX2CRX ("-x")   */
+/*     lists those epochs with their byte offset and line number in the     */
+/*     Compact RINEX file, and CRX2RNX ("-t") starts from the last of them  */
+/*     before the requested time instead of from the first epoch.           */
+/*                                                                          */
+/*     The index is a text file (name of the Compact RINEX file + ".idx"):  */
+/*         CRX INDEX 1 <size of the Compact RINEX file in bytes>            */
+/*         <offset> <line> <yyyy> <mm> <dd> <hh> <mm> <ss.sssssss>          */
+/*         ...                                                              */
+/*     Only the epochs before the first change of the observation types    */
+/*     (by event records) are listed, so that the types in the header are   */
+/*     valid at every listed epoch. An index whose size does not match the  */
+/*     Compact RINEX file is ignored.                                       */
+/****************************************************************************/
+#ifndef CRX_INDEX_H
+#define CRX_INDEX_H
+
+#include <vector>
+
+#define INDEX_SUFFIX ".idx"
+
+struct epoch_time {
+    int year, month, day, hour, minute;
+    double sec;
+};
+
+struct index_entry {
+    unsigned long long offset;  /* byte offset of the epoch line */
+    long line;                  /* line number of the epoch line (1: first line) */
+    epoch_time time;
+};
+
+/**** read the time of an epoch line of RINEX 2/3/4 (also of Compact  ****/
+/**** RINEX at an initialized epoch). returns 0, or -1 if it is blank ****/
+int    read_epoch_time(const char* line, epoch_time* t);
+
+/**** time given in an option: "yyyy-mm-ddThh:mm[:ss]". returns 0 or -1 ****/
+int    parse_time(const char* s, epoch_time* t);
+
+/**** value in the order of the times (not the seconds from some epoch) ****/
+double time_key(const epoch_time* t);
+
+class crx_index {
+public:
+    crx_index() : size(0) {}
+
+    void add(unsigned long long offset, long line, const epoch_time* t);
+    int  write(const char* crx_file) const;       /* 0 or -1 */
+    int  read(const char* crx_file);              /* 0 or -1 (no index, or not of this file) */
+    const index_entry* find(const epoch_time* t) const; /* last entry before t (or NULL) */
+
+    std::vector<index_entry> entry;
+    unsigned long long size;    /* size of the Compact RINEX file */
+};
+
+#endif
@@ -0,0 +1,66 @@
+/****************************************************************************/
+/*     epoch_table.h : table of the satellites x data types of one epoch    */
+/*                                                                          */
+/*     The tables of the data and the flags are allocated for the number    */
+/*     of data types found in the header and the number of satellites seen  */
+/*     so far, not for the largest file that can be thought of. reserve()   */
+/*     enlarges the table when a larger epoch or a new data type appears;   */
+/*     the elements already in the table are kept at the same [i][j], and   */
+/*     the new ones are set to zero.                                        */
+/*                                                                          */
+/*     row[i] points to the i-th row, so the elements are written as        */
+/*     row[i][j]. row changes when the table is enlarged.                   */
+/****************************************************************************/
+#ifndef EPOCH_TABLE_H
+#define EPOCH_TABLE_H
+
+#include <stdlib.h>
+#include <string.h>
+
+template <class T>
+class epoch_table {
+public:
+    epoch_table() { row = NULL; base = NULL; nrow = ncol = 0; }
+    ~epoch_table() { free(row); free(base); }
+
+    int  reserve(int n, int m);     /* at least n rows of m elements. 0: OK, -1: no memory */
+    int  rows(void) const { return nrow; }
+    int  cols(void) const { return ncol; }
+
+    T** row;
+
+private:
+    T* base;
+    int nrow, ncol;
+
+    epoch_table(const epoch_table&) = delete;
+    epoch_table& operator=(const epoch_table&) = delete;
+};
+
+/*---------------------------------------------------------------------*/
+template <class T>
+int  epoch_table<T>::reserve(int n, int m) {
+    T* new_base, ** new_row;
+    int i;
+
+    if (n < 1) n = 1;
+    if (m < 1) m = 1;
+    if (n <= nrow && m <= ncol) return 0;
+    if (n < nrow) n = nrow;
+    if (m < ncol) m = ncol;
+    if (n > nrow && n < nrow * 2) n = nrow * 2;    /** grow by doubling **/
+
+    if ((new_base = (T*)calloc((size_t)n * (size_t)m, sizeof(T))) == NULL) return -1;
+    if ((new_row = (T**)malloc((size_t)n * sizeof(T*))) == NULL) { free(new_base); return -1; }
+    for (i = 0; i < n; i++) new_row[i] = new_base + (size_t)i * (size_t)m;
+    for (i = 0; i < nrow; i++) memcpy(new_row[i], row[i], (size_t)ncol * sizeof(T));
+
+    free(row); free(base);
+    row = new_row;
+    base = new_base;
+    nrow = n;
+    ncol = m;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,67 @@
+/****************************************************************************/
+/*     f14_field.cpp : data fields of the RINEX observation records         */
+/****************************************************************************/
+
+#include <string.h>
+
+#include "f14_field.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define F14_FIELD_SSE2
+#endif
+
+/*---------------------------------------------------------------------*/
+int f14_scan(const char* p, fixed_t* y) {
+    /**** masks of the columns (bit i : column i+1) ****/
+    unsigned int dm, sm, mm;
+    unsigned char d[16];        /* value of the digits, 0 for the other characters */
+    unsigned long long u;
+#if defined(F14_FIELD_SSE2)
+    __m128i c, t, isd;
+
+    c = _mm_loadu_si128((const __m128i*)p);
+    t = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    isd = _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8(9)), t);     /** '0' <= c <= '9' **/
+    dm = (unsigned int)_mm_movemask_epi8(isd);
+    sm = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(c, _mm_set1_epi8(' ')));
+    mm = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(c, _mm_set1_epi8('-')));
+    _mm_storeu_si128((__m128i*)d, _mm_and_si128(t, isd));
+#else
+    int i;
+
+    dm = sm = mm = 0;
+    for (i = 0; i < 16; i++) {
+        d[i] = (unsigned char)(p[i] - '0');
+        if (d[i] <= 9) dm |= 1u << i;
+        else d[i] = 0;
+        if (p[i] == ' ') sm |= 1u << i;
+        else if (p[i] == '-') mm |= 1u << i;
+    }
+#endif
+    if ((sm & 0x3FFF) == 0x3FFF) return F14_BLANK;
+    if (p[10] != '.' || (dm & 0x3800) != 0x3800) return F14_OTHER;
+
+    /**** columns 1-10 : blanks (sm = 0...01...1), '-' just after them, ****/
+    /**** and digits up to the column 10                                 ****/
+    sm &= 0x3FF; mm &= 0x3FF; dm &= 0x3FF;
+    if ((sm | mm | dm) != 0x3FF || (sm & (sm + 1)) != 0 || (mm != 0 && mm != sm + 1)) return F14_OTHER;
+
+#if defined(F14_FIELD_SSE2)
+    /**** columns 1-8 : 8 digits at once (x86 is little endian) ****/
+    memcpy(&u, d, 8);
+    u = u * 10 + (u >> 8);
+    u = (((u & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32)))
+        + (((u >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+#else
+    for (i = 0, u = 0; i < 8; i++) u = u * 10 + d[i];
+#endif
+    /**** '-' in the columns 1-7 and only zeros up to the column 8     ****/
+    /**** (e.g. "   -000001.000"): read_value() drops the sign of such ****/
+    /**** a field, so it is left to read_value() as before             ****/
+    if ((mm & 0x7F) != 0 && u == 0) return F14_OTHER;
+    u = u * 100 + d[8] * 10 + d[9];
+    u = u * 1000 + d[11] * 100 + d[12] * 10 + d[13];
+    *y = (mm != 0) ? -(fixed_t)u : (fixed_t)u;
+    return F14_VALUE;
+}
@@ -0,0 +1,29 @@
+/****************************************************************************/
+/*     f14_field.h : data fields of the RINEX observation records           */
+/*                                                                          */
+/*     f14_scan() classifies one field of 16 columns (F14.3 and 2 flags)   */
+/*     and converts the value in one pass over the input, without copying  */
+/*     or modifying it. The digits, blanks, '.' and '-' of the field are    */
+/*     found at once with SSE2 when the compiler targets it, otherwise      */
+/*     byte by byte.                                                        */
+/*                                                                          */
+/*     A field is "in the form of F14.3" if the columns 1-10 are blanks,    */
+/*     at most one '-' and digits, in this order, column 11 is '.', and    */
+/*     the columns 12-14 are digits. Other fields (e.g. "1 2.345",         */
+/*     "+1.234", '\0') are left to the caller, which handles them as        */
+/*     before. So are the fields with '-' followed by zeros up to the       */
+/*     column 8 (e.g. "   -000001.000"), whose sign read_value() drops.     */
+/****************************************************************************/
+#ifndef F14_FIELD_H
+#define F14_FIELD_H
+
+#include "fixed_value.h"
+
+#define F14_VALUE   1           /* in the form of F14.3. *y = value*1000 */
+#define F14_BLANK   0           /* columns 1-14 are blank */
+#define F14_OTHER (-1)          /* otherwise (*y is not set) */
+
+/**** p : 16 readable characters ****/
+int f14_scan(const char* p, fixed_t* y);
+
+#endif
@@ -0,0 +1,34 @@
+/****************************************************************************/
+/*     fixed_value.h : 64-bit fixed-point values of RINEX data              */
+/*                                                                          */
+/*     An observation (F14.3) is held as one integer value*1000, and a      */
+/*     clock offset as one integer of all its digits, instead of a pair of  */
+/*     upper and lower digits in two longs. The differences are then plain  */
+/*     integer operations without carrying between the pair.               */
+/*                                                                          */
+/*     The magnitude is kept below FIXED_LIMIT (10^18), which is far beyond */
+/*     any value in a RINEX file, so the sum or difference of two values    */
+/*     never overflows. fixed_add() saturates at +-FIXED_LIMIT; a value     */
+/*     reaching the limit is treated as out of range by the caller.         */
+/****************************************************************************/
+#ifndef FIXED_VALUE_H
+#define FIXED_VALUE_H
+
+typedef long long fixed_t;
+
+#define FIXED_LIMIT 1000000000000000000LL   /* 10^18 */
+
+/*---------------------------------------------------------------------*/
+inline int fixed_in_range(fixed_t y) {
+    return y < FIXED_LIMIT && y > -FIXED_LIMIT;
+}
+/*---------------------------------------------------------------------*/
+inline fixed_t fixed_add(fixed_t a, fixed_t b) {
+    /**** |a|, |b| <= FIXED_LIMIT ****/
+    fixed_t s = a + b;
+    if (s >= FIXED_LIMIT) return FIXED_LIMIT;
+    if (s <= -FIXED_LIMIT) return -FIXED_LIMIT;
+    return s;
+}
+
+#endif
@@ -0,0 +1,60 @@
+/****************************************************************************/
+/*     int_text.cpp : conversion of integers to decimal text                */
+/****************************************************************************/
+
+#include <string.h>
+
+#include "int_text.h"
+
+const char digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/*---------------------------------------------------------------------*/
+static char* put_digits(char* p, unsigned long long v) {
+    /**** decimal digits of v ****/
+    char tmp[24], * q = tmp + sizeof(tmp);
+    const char* d;
+    size_t n;
+
+    while (v >= 100) {
+        d = digit_pairs + (v % 100) * 2;
+        v /= 100;
+        *--q = d[1];
+        *--q = d[0];
+    }
+    if (v >= 10) {
+        d = digit_pairs + v * 2;
+        *--q = d[1];
+        *--q = d[0];
+    }
+    else {
+        *--q = (char)('0' + v);
+    }
+
+    n = (size_t)(tmp + sizeof(tmp) - q);
+    memcpy(p, q, n);
+    p += n;
+    *p = '\0';
+    return p;
+}
+/*---------------------------------------------------------------------*/
+char* put_long(char* p, long v) {
+    return put_llong(p, v);
+}
+/*---------------------------------------------------------------------*/
+char* put_llong(char* p, long long v) {
+    if (v < 0) {
+        *p++ = '-';
+        return put_digits(p, 0ULL - (unsigned long long)v);
+    }
+    return put_digits(p, (unsigned long long)v);
+}
@@ -0,0 +1,17 @@
+/****************************************************************************/
+/*     int_text.h : conversion of integers to decimal text                  */
+/*                                                                          */
+/*     Replacements of sprintf() for the integer fields of Compact RINEX.   */
+/*     The digits are produced two at a time from a table of "00" ... "99" */
+/*     without varargs or locale. Like sprintf(), each function puts '\0'  */
+/*     after the text and returns the pointer to it (not the count).        */
+/****************************************************************************/
+#ifndef INT_TEXT_H
+#define INT_TEXT_H
+
+extern const char digit_pairs[201];     /* "000102...9899" */
+
+char* put_long(char* p, long v);        /* sprintf(p, "%ld", v) */
+char* put_llong(char* p, long long v);  /* sprintf(p, "%lld", v) */
+
+#endif
@@ -0,0 +1,326 @@
+/****************************************************************************/
+/*     line_reader.cpp : line input from a memory-mapped file               */
+/****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#include <sys/stat.h>
+#define fileno _fileno
+#define read_fd(fd,buf,n) _read(fd, buf, (unsigned int)(n))
+#define seek_fd(fd,offset,whence) _lseeki64(fd, (__int64)(offset), whence)
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define read_fd(fd,buf,n) read(fd, buf, n)
+#define seek_fd(fd,offset,whence) lseek(fd, (off_t)(offset), whence)
+#endif
+
+#include "line_reader.h"
+
+/*---------------------------------------------------------------------*/
+line_reader::line_reader() {
+    fd = -1;
+    map = NULL;
+    map_size = 0;
+    map_handle = NULL;
+    borrowed = 0;
+    buff = NULL;
+    data = NULL;
+    pos = end = 0;
+    base = 0;
+    src_eof = at_eof = 1;
+    follow_ms = 0;
+    follow_marker = NULL;
+    following = 0;
+    loaded = spare = NULL;
+    chunk_mem = NULL;
+    chunk.p = NULL;
+    chunk.n = chunk_pos = 0;
+    stop = 0;
+}
+/*---------------------------------------------------------------------*/
+line_reader::~line_reader() {
+    close();
+    free(buff);
+}
+/*---------------------------------------------------------------------*/
+void line_reader::open(FILE* fp, int use_mmap, int threaded) {
+    close();
+    fd = fileno(fp);
+    pos = end = 0;
+    base = 0;
+    src_eof = at_eof = 0;
+    if (threaded) use_mmap = 0;
+    following = 0;
+    if (follow_ms > 0) {
+#ifdef _WIN32
+        struct _stat64 st;
+        following = (_fstat64(fd, &st) == 0 && (st.st_mode & _S_IFREG) != 0);
+#else
+        struct stat st;
+        following = (fstat(fd, &st) == 0 && S_ISREG(st.st_mode));
+#endif
+        if (following) use_mmap = threaded = 0;     /** the size is not fixed **/
+    }
+
+    /**** map the file if it is a regular file read from the top ****/
+    if (use_mmap && ftell(fp) == 0) {
+#ifdef _WIN32
+        HANDLE h = (HANDLE)_get_osfhandle(fd);
+        LARGE_INTEGER size;
+        if (h != INVALID_HANDLE_VALUE && GetFileType(h) == FILE_TYPE_DISK
+            && GetFileSizeEx(h, &size) && size.QuadPart > 0 && (unsigned long long)size.QuadPart <= (size_t)-1) {
+            map_handle = CreateFileMapping(h, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (map_handle != NULL) {
+                map = (char*)MapViewOfFile(map_handle, FILE_MAP_READ, 0, 0, 0);
+                if (map == NULL) { CloseHandle(map_handle); map_handle = NULL; }
+                else map_size = (size_t)size.QuadPart;
+            }
+        }
+#else
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0
+            && (unsigned long long)st.st_size <= (size_t)-1) {
+            void* p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                map = (char*)p;
+                map_size = (size_t)st.st_size;
+                madvise(p, map_size, MADV_SEQUENTIAL);
+            }
+        }
+#endif
+    }
+    if (map != NULL) {
+        data = map;
+        end = map_size;
+        src_eof = 1;
+    }
+    else {
+        if (buff == NULL && (buff = (char*)malloc(READ_BUFF_SIZE)) == NULL) {
+            src_eof = at_eof = 1;   /** treated as an empty input **/
+        }
+        data = buff;
+        if (threaded && buff != NULL && (chunk_mem = (char*)malloc((size_t)READ_NCHUNK * READ_CHUNK_SIZE)) != NULL) {
+            start_loader();
+        }
+    }
+}
+/*---------------------------------------------------------------------*/
+void line_reader::open_memory(const char* p, size_t n) {
+    close();
+    map = (char*)p;
+    map_size = n;
+    borrowed = 1;
+    data = map;
+    pos = 0;
+    end = n;
+    base = 0;
+    src_eof = 1;
+    at_eof = (n == 0);
+}
+/*---------------------------------------------------------------------*/
+void line_reader::follow(int poll_ms, const char* marker) {
+    follow_ms = (poll_ms > 0) ? poll_ms : 0;
+    follow_marker = marker;
+}
+/*---------------------------------------------------------------------*/
+void line_reader::wait_more(void) {
+    /**** at the end of a followed file: wait follow_ms before reading ****/
+    /**** again, or stop following if the marker is there             ****/
+    FILE* fp;
+
+    if (follow_marker != NULL && (fp = fopen(follow_marker, "r")) != NULL) {
+        fclose(fp);
+        following = 0;      /** read once more the bytes written before the marker **/
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(follow_ms));
+}
+/*---------------------------------------------------------------------*/
+void line_reader::start_loader(void) {
+    int i;
+
+    loaded = new chunk_ring;
+    spare = new chunk_ring;
+    for (i = 0; i < READ_NCHUNK; i++) {
+        chunk.p = chunk_mem + (size_t)i * READ_CHUNK_SIZE;
+        spare->put(chunk);
+    }
+    chunk.n = chunk_pos = 0;
+    stop = 0;
+    loader = std::thread(&line_reader::load, this);
+}
+/*---------------------------------------------------------------------*/
+void line_reader::stop_loader(void) {
+    stop = 1;
+    loader.join();
+    delete loaded;
+    delete spare;
+    loaded = spare = NULL;
+    chunk.n = 0;
+}
+/*---------------------------------------------------------------------*/
+void line_reader::close(void) {
+    if (loader.joinable()) stop_loader();
+    free(chunk_mem);
+    chunk_mem = NULL;
+    if (map != NULL) {
+        if (!borrowed) {
+#ifdef _WIN32
+            UnmapViewOfFile(map);
+            CloseHandle(map_handle);
+            map_handle = NULL;
+#else
+            munmap(map, map_size);
+#endif
+        }
+        map = NULL;
+        map_size = 0;
+        borrowed = 0;
+    }
+    data = NULL;
+    pos = end = 0;
+    src_eof = at_eof = 1;
+}
+/*---------------------------------------------------------------------*/
+void line_reader::read_more(void) {
+    /**** append the bytes that can be read now to the buffer ****/
+    long n;
+
+    if (loaded != NULL) {
+        take_chunk();
+        return;
+    }
+    if (pos > 0 && READ_BUFF_SIZE - end < READ_BUFF_SIZE / 16) {
+        memmove(buff, buff + pos, end - pos);
+        end -= pos;
+        base += pos;
+        pos = 0;
+    }
+    do {
+        n = (long)read_fd(fd, buff + end, READ_BUFF_SIZE - end);
+    } while (n < 0 && errno == EINTR);
+    if (n == 0 && following && end < READ_BUFF_SIZE) {
+        wait_more();
+        return;
+    }
+    if (n <= 0) src_eof = 1;
+    else end += (size_t)n;
+}
+/*---------------------------------------------------------------------*/
+void line_reader::take_chunk(void) {
+    /**** append the next chunk of the reader thread to the buffer ****/
+    size_t n;
+
+    if (chunk.n == 0) {
+        loaded->get(&chunk);
+        chunk_pos = 0;
+        if (chunk.n == 0) {
+            src_eof = 1;
+            return;
+        }
+    }
+    n = chunk.n - chunk_pos;
+    if (pos > 0 && READ_BUFF_SIZE - end < n) {
+        memmove(buff, buff + pos, end - pos);
+        end -= pos;
+        base += pos;
+        pos = 0;
+    }
+    if (n > READ_BUFF_SIZE - end) n = READ_BUFF_SIZE - end;
+    memcpy(buff + end, chunk.p + chunk_pos, n);
+    end += n;
+    chunk_pos += n;
+    if (chunk_pos == chunk.n) {     /** give the chunk back to the reader **/
+        spare->put(chunk);
+        chunk.n = 0;
+    }
+}
+/*---------------------------------------------------------------------*/
+void line_reader::load(void) {
+    /**** reader thread : read the input into the spare chunks ****/
+    read_chunk c;
+    long n;
+    int k;
+
+    for (;;) {
+        for (k = 0; !spare->try_get(&c); k++) {
+            if (stop) return;
+            ring_wait(k);
+        }
+        do {
+            n = (long)read_fd(fd, c.p, READ_CHUNK_SIZE);
+        } while (n < 0 && errno == EINTR);
+        c.n = (n > 0) ? (size_t)n : 0;
+        for (k = 0; !loaded->try_put(c); k++) {
+            if (stop) return;
+            ring_wait(k);
+        }
+        if (c.n == 0) return;
+    }
+}
+/*---------------------------------------------------------------------*/
+const char* line_reader::next(int n, size_t* len) {
+    const char* p, * q;
+    size_t m, maxc;
+
+    if (n < 2) return NULL;
+    maxc = (size_t)n - 1;
+    for (;;) {
+        m = end - pos;
+        if (m > maxc) m = maxc;
+        q = (m > 0) ? (const char*)memchr(data + pos, '\n', m) : NULL;
+        if (q != NULL || m == maxc || src_eof) break;
+        read_more();        /** (only if not mapped) **/
+    }
+    if (m == 0) {
+        at_eof = 1;
+        return NULL;
+    }
+    p = data + pos;
+    if (q != NULL) {
+        *len = (size_t)(q - p) + 1;
+    }
+    else {
+        *len = m;
+        if (m < maxc) at_eof = 1;   /** the last line without '\n' **/
+    }
+    pos += *len;
+    return p;
+}
+/*---------------------------------------------------------------------*/
+int  line_reader::get_char(void) {
+    while (pos == end && !src_eof) read_more();
+    if (pos < end) return (unsigned char)data[pos++];
+    at_eof = 1;
+    return EOF;
+}
+/*---------------------------------------------------------------------*/
+int  line_reader::seek(unsigned long long offset) {
+    if (map != NULL) {
+        if (offset > map_size) return -1;
+        pos = (size_t)offset;
+    }
+    else {
+        if (buff == NULL || seek_fd(fd, 0, SEEK_CUR) < 0) return -1;    /** pipe or terminal **/
+        if (loader.joinable()) stop_loader();
+        pos = end = 0;
+        base = offset;
+        if (seek_fd(fd, offset, SEEK_SET) < 0) {
+            src_eof = at_eof = 1;
+            return -1;
+        }
+        src_eof = 0;
+        if (chunk_mem != NULL) start_loader();
+    }
+    at_eof = 0;
+    return 0;
+}
@@ -0,0 +1,114 @@
+/****************************************************************************/
+/*     line_reader.h : line input from a memory-mapped file                 */
+/*                                                                          */
+/*     next() hands out the next line as a pointer into the mapped file    */
+/*     and its length, split in the same way as fgets(buf, n, fp): at most  */
+/*     n-1 bytes, up to and including the first '\n'. The bytes are NOT     */
+/*     terminated by '\0', so callers must not read beyond the length.      */
+/*                                                                          */
+/*     If the input can not be mapped (pipe, terminal, empty file, or       */
+/*     use_mmap == 0), it is read with read() into a large buffer. In that  */
+/*     case a line is valid only until the next call of next()/get_char(). */
+/*                                                                          */
+/*     With threaded == 1 (option "-p"), the input is not mapped but read   */
+/*     by a thread of its own into chunks of READ_CHUNK_SIZE, which are     */
+/*     passed through a ring to the converting thread; the disk or the      */
+/*     pipe is then read while the previous chunks are converted.           */
+/*                                                                          */
+/*     seek() continues the input at a byte offset of the file (e.g. of an  */
+/*     epoch found in an index). It fails for pipes and terminals.          */
+/*     open_memory() reads the lines of a buffer of the caller (e.g. one    */
+/*     part of a file mapped by another line_reader) in the same way.       */
+/*                                                                          */
+/*     With follow() before open(), a regular file that is still written    */
+/*     (e.g. by a receiver) is read with read() also at its end: when no    */
+/*     more bytes are there, the file is polled every "poll_ms" ms, and     */
+/*     a line is handed out only when it is complete. The input ends when  */
+/*     the file "marker" exists (the bytes written before it are read       */
+/*     first); without marker, the caller has to stop reading by itself.   */
+/****************************************************************************/
+#ifndef LINE_READER_H
+#define LINE_READER_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+
+#include "spsc_ring.h"
+
+#define READ_BUFF_SIZE 1048576  /* size of the buffer when the input is not mapped */
+#define READ_CHUNK_SIZE 262144  /* size of a chunk read by the reader thread */
+#define READ_NCHUNK    8        /* number of the chunks (a power of 2) */
+
+struct read_chunk {
+    char* p;
+    size_t n;                   /* 0 : end of the input */
+};
+typedef spsc_ring<read_chunk, READ_NCHUNK> chunk_ring;
+
+class line_reader {
+public:
+    line_reader();
+    ~line_reader();
+
+    void open(FILE* fp, int use_mmap, int threaded = 0);
+    void open_memory(const char* p, size_t n);  /* p[0] ... p[n-1] (not copied) */
+    void follow(int poll_ms, const char* marker);   /* poll_ms = 0: not followed */
+    void close(void);
+    const char* next(int n, size_t* len);   /* NULL at the end of the input */
+    int  get_char(void);                    /* same as fgetc() */
+    int  seek(unsigned long long offset);   /* continue at the byte "offset". 0 or -1 */
+    unsigned long long tell(void) const { return base + pos; }  /* offset of the next line */
+    int  eof(void) const { return at_eof; } /* same as feof() */
+    int  mapped(void) const { return map != NULL; }
+    const char* map_data(void) const { return map; }    /* whole input if mapped */
+    size_t map_length(void) const { return map_size; }
+
+private:
+    int   fd;
+    char* map;                  /* whole file if mapped */
+    size_t map_size;
+    void* map_handle;           /* file mapping object (Windows) */
+    int   borrowed;             /* =1 map is the buffer of open_memory() */
+    char* buff;                 /* buffer if not mapped */
+    const char* data;           /* = map or buff */
+    size_t pos, end;            /* unread bytes are data[pos] ... data[end-1] */
+    unsigned long long base;    /* offset of data[0] in the input */
+    int   src_eof;              /* no more bytes can be read into buff */
+    int   at_eof;
+    int   follow_ms;            /* interval of the polling at the end of the file (follow()) */
+    const char* follow_marker;  /* the input ends when this file exists (NULL: never) */
+    int   following;            /* =1 the end of the file is polled (a regular file) */
+
+    /**** reader thread (threaded == 1) ****/
+    std::thread loader;
+    chunk_ring* loaded;         /* chunks read, in order */
+    chunk_ring* spare;          /* chunks to be read into */
+    char* chunk_mem;
+    read_chunk chunk;           /* chunk being copied to buff (n = 0 : none) */
+    size_t chunk_pos;
+    std::atomic<int> stop;
+
+    void read_more(void);
+    void wait_more(void);
+    void take_chunk(void);
+    void load(void);
+    void start_loader(void);
+    void stop_loader(void);
+
+    line_reader(const line_reader&) = delete;
+    line_reader& operator=(const line_reader&) = delete;
+};
+
+/*---------------------------------------------------------------------*/
+inline const char* find_newline(const char* line, size_t len) {
+    /**** the '\n' that strchr(line, '\n') would find if the line  ****/
+    /**** had been read by fgets(): it can only be the last byte,  ****/
+    /**** and it is not found if the line contains '\0'.           ****/
+    if (len == 0 || line[len - 1] != '\n' || memchr(line, '\0', len - 1) != NULL) return NULL;
+    return line + len - 1;
+}
+
+#endif
@@ -0,0 +1,59 @@
+/****************************************************************************/
+/*     sat_index.cpp : direct-indexed table of the satellites in one epoch  */
+/****************************************************************************/
+
+#include <limits.h>
+#include <string.h>
+
+#include "sat_index.h"
+
+/*---------------------------------------------------------------------*/
+sat_index::sat_index() {
+    stamp = 0;
+    dup = -1;
+    memset(slot_stamp, 0, sizeof(slot_stamp));
+}
+/*---------------------------------------------------------------------*/
+int  sat_index::key(const char* p) {
+    int s, t, u;
+
+    if (p[0] == ' ') s = 0;
+    else if (p[0] >= 'A' && p[0] <= 'Z') s = p[0] - 'A' + 1;
+    else return -1;
+    if (p[1] == ' ') t = 0;
+    else if (p[1] >= '0' && p[1] <= '9') t = p[1] - '0' + 1;
+    else return -1;
+    if (p[2] >= '0' && p[2] <= '9') u = p[2] - '0';
+    else return -1;
+    return (s * 11 + t) * 10 + u;
+}
+/*---------------------------------------------------------------------*/
+int  sat_index::set(const char* p_lst, int n) {
+    /**** index the list of n satellites (3 characters each) ****/
+    int i, k;
+
+    if (stamp == INT_MAX) {     /** wrap around (practically never) **/
+        memset(slot_stamp, 0, sizeof(slot_stamp));
+        stamp = 0;
+    }
+    stamp++;
+    dup = -1;
+    for (i = 0; i < n; i++, p_lst += 3) {
+        if ((k = key(p_lst)) < 0) return -1;
+        if (slot_stamp[k] == stamp) {
+            if (dup < 0 || slot[k] < dup) dup = slot[k];
+        }
+        else {
+            slot_stamp[k] = stamp;
+            slot[k] = i;
+        }
+    }
+    return 0;
+}
+/*---------------------------------------------------------------------*/
+int  sat_index::find(const char* p) const {
+    int k;
+
+    if ((k = key(p)) < 0 || slot_stamp[k] != stamp) return -1;
+    return slot[k];
+}
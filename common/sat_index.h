@@ -0,0 +1,38 @@
+/****************************************************************************/
+/*     sat_index.h : direct-indexed table of the satellites in one epoch    */
+/*                                                                          */
+/*     A satellite "Xnn" (system letter or blank, PRN of 2 characters) is   */
+/*     mapped to one entry of a fixed table, so the position of a           */
+/*     satellite in the list of an epoch and a duplicated satellite are     */
+/*     found without comparing the lists. The table is not cleared for     */
+/*     each epoch: an entry is valid only if its stamp is that of the last  */
+/*     set().                                                               */
+/*                                                                          */
+/*     Satellites written in another form (lower case, '\0' in a truncated */
+/*     line, ...) can not be indexed; set() then returns -1 and the caller  */
+/*     must compare the lists with strncmp() as before.                     */
+/****************************************************************************/
+#ifndef SAT_INDEX_H
+#define SAT_INDEX_H
+
+#define NSATKEY (27 * 11 * 10)  /* (blank, A-Z) x (blank, 0-9) x (0-9) */
+
+class sat_index {
+public:
+    sat_index();
+
+    int  set(const char* p_lst, int n);     /* 0: indexed, -1: can not be indexed */
+    int  find(const char* p) const;         /* position in the list, -1 if not in it */
+                                            /* (valid only after set() returned 0) */
+    int  first_duplicate(void) const { return dup; }  /* -1 if no duplication */
+
+    static int key(const char* p);          /* -1 if not in the form "Xnn" */
+
+private:
+    int stamp;
+    int dup;                    /* first satellite found again later in the list */
+    int slot[NSATKEY];          /* position in the list */
+    int slot_stamp[NSATKEY];
+};
+
+#endif
@@ -0,0 +1,62 @@
+/****************************************************************************/
+/*     spsc_ring.h : bounded ring buffer between two threads                */
+/*                                                                          */
+/*     Used by the pipeline of RNX2CRX and CRX2RNX ("-p") to pass the       */
+/*     blocks of the input and of the output between the reader, the       */
+/*     converter and the writer. Only one thread may put() and only one     */
+/*     thread may get() on a ring. The positions are atomic counters, so    */
+/*     no lock is taken; a thread that finds the ring full (put) or empty   */
+/*     (get) spins for a while, then yields, and then sleeps shortly.      */
+/****************************************************************************/
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stddef.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+/*---------------------------------------------------------------------*/
+inline void ring_wait(int n) {
+    /**** n : number of the failed tries so far ****/
+    if (n < 64) return;
+    if (n < 1024) std::this_thread::yield();
+    else std::this_thread::sleep_for(std::chrono::microseconds(100));
+}
+
+/**** N : capacity (a power of 2) ****/
+template <class T, size_t N>
+class spsc_ring {
+public:
+    spsc_ring() : head(0), tail(0) {}
+
+    int try_put(const T& v) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == N) return 0;   /** full **/
+        slot[t & (N - 1)] = v;
+        tail.store(t + 1, std::memory_order_release);
+        return 1;
+    }
+    int try_get(T* v) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (tail.load(std::memory_order_acquire) == h) return 0;       /** empty **/
+        *v = slot[h & (N - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return 1;
+    }
+    void put(const T& v) { for (int n = 0; !try_put(v); n++) ring_wait(n); }
+    void get(T* v) { for (int n = 0; !try_get(v); n++) ring_wait(n); }
+
+private:
+    static_assert(N > 0 && (N & (N - 1)) == 0, "capacity of spsc_ring must be a power of 2");
+    T slot[N];
+    char pad0[64];
+    std::atomic<size_t> head;   /* written by the consumer */
+    char pad1[64];              /* (the two counters on different cache lines) */
+    std::atomic<size_t> tail;   /* written by the producer */
+
+    spsc_ring(const spsc_ring&) = delete;
+    spsc_ring& operator=(const spsc_ring&) = delete;
+};
+
+#endif
@@ -0,0 +1,123 @@
+/****************************************************************************/
+/*     str_diff.cpp : difference of the epoch lines and the flag strings    */
+/****************************************************************************/
+
+#include <string.h>
+
+#include "str_diff.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define STR_DIFF_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define STR_DIFF_NEON
+#endif
+
+/*---------------------------------------------------------------------*/
+static size_t diff_blocks(const char* s1, const char* s2, char* ds, size_t n) {
+    /**** ds[i] = (s2[i] == s1[i]) ? ' ' : (s2[i] == ' ') ? '&' : s2[i] ****/
+    /**** for the blocks of 16 bytes in [0, n). returns the bytes done.  ****/
+    size_t i = 0;
+#if defined(STR_DIFF_SSE2)
+    const __m128i space = _mm_set1_epi8(' '), amp = _mm_set1_epi8('&');
+    __m128i a, b, eq, sp, t;
+
+    for (; i + 16 <= n; i += 16) {
+        a = _mm_loadu_si128((const __m128i*)(s1 + i));
+        b = _mm_loadu_si128((const __m128i*)(s2 + i));
+        eq = _mm_cmpeq_epi8(a, b);
+        sp = _mm_cmpeq_epi8(b, space);
+        t = _mm_or_si128(_mm_and_si128(sp, amp), _mm_andnot_si128(sp, b));
+        t = _mm_or_si128(_mm_and_si128(eq, space), _mm_andnot_si128(eq, t));
+        _mm_storeu_si128((__m128i*)(ds + i), t);
+    }
+#elif defined(STR_DIFF_NEON)
+    const uint8x16_t space = vdupq_n_u8(' '), amp = vdupq_n_u8('&');
+    uint8x16_t a, b, t;
+
+    for (; i + 16 <= n; i += 16) {
+        a = vld1q_u8((const uint8_t*)(s1 + i));
+        b = vld1q_u8((const uint8_t*)(s2 + i));
+        t = vbslq_u8(vceqq_u8(b, space), amp, b);
+        vst1q_u8((uint8_t*)(ds + i), vbslq_u8(vceqq_u8(a, b), space, t));
+    }
+#else
+    (void)s1; (void)s2; (void)ds; (void)n;
+#endif
+    return i;
+}
+/*---------------------------------------------------------------------*/
+static size_t repair_blocks(char* s, const char* ds, size_t n) {
+    /**** s[i] = (ds[i] == ' ') ? s[i] : (ds[i] == '&') ? ' ' : ds[i]   ****/
+    /**** for the blocks of 16 bytes in [0, n). returns the bytes done.  ****/
+    size_t i = 0;
+#if defined(STR_DIFF_SSE2)
+    const __m128i space = _mm_set1_epi8(' '), amp = _mm_set1_epi8('&');
+    __m128i a, b, sp, am, t;
+
+    for (; i + 16 <= n; i += 16) {
+        a = _mm_loadu_si128((const __m128i*)(s + i));
+        b = _mm_loadu_si128((const __m128i*)(ds + i));
+        sp = _mm_cmpeq_epi8(b, space);
+        am = _mm_cmpeq_epi8(b, amp);
+        t = _mm_or_si128(_mm_and_si128(am, space), _mm_andnot_si128(am, b));
+        t = _mm_or_si128(_mm_and_si128(sp, a), _mm_andnot_si128(sp, t));
+        _mm_storeu_si128((__m128i*)(s + i), t);
+    }
+#elif defined(STR_DIFF_NEON)
+    const uint8x16_t space = vdupq_n_u8(' '), amp = vdupq_n_u8('&');
+    uint8x16_t a, b, t;
+
+    for (; i + 16 <= n; i += 16) {
+        a = vld1q_u8((const uint8_t*)(s + i));
+        b = vld1q_u8((const uint8_t*)(ds + i));
+        t = vbslq_u8(vceqq_u8(b, amp), space, b);
+        vst1q_u8((uint8_t*)(s + i), vbslq_u8(vceqq_u8(b, space), a, t));
+    }
+#else
+    (void)s; (void)ds; (void)n;
+#endif
+    return i;
+}
+/*---------------------------------------------------------------------*/
+char* str_diff(const char* s1, const char* s2, char* ds) {
+    /********************************************************************/
+    /**   copy only the difference of string s2 from string s1         **/
+    /**   '&' is marked when some character changed to a space         **/
+    /**   trailing blank is eliminated and '/n' is added               **/
+    /********************************************************************/
+    size_t n1, n2, n, i;
+
+    n1 = strlen(s1);
+    n2 = strlen(s2);
+    if (n1 != n2 || memcmp(s1, s2, n1) != 0) {   /*** if unchanged, all would be spaces ***/
+        n = (n1 < n2) ? n1 : n2;
+        i = diff_blocks(s1, s2, ds, n);
+        for (; i < n; i++) ds[i] = (s2[i] == s1[i]) ? ' ' : (s2[i] == ' ') ? '&' : s2[i];
+        for (; i < n1; i++) ds[i] = (s1[i] == ' ') ? ' ' : '&';    /*** erased characters ***/
+        for (; i < n2; i++) ds[i] = s2[i];                          /*** new characters ***/
+        ds += i;
+    }
+    for (ds--; *ds == ' '; ds--);    /*** find pointer of last non-space character ***/
+    *++ds = '\n'; *++ds = '\0';       /*** chop spaces at the end of the line ***/
+    return ds;
+}
+/*---------------------------------------------------------------------*/
+void str_repair(char* s, const char* ds) {
+    size_t n1, n2, n, i;
+
+    if (*ds == '\0') return;        /*** no change ***/
+    n1 = strlen(s);
+    n2 = strlen(ds);
+    n = (n1 < n2) ? n1 : n2;
+    i = repair_blocks(s, ds, n);
+    for (; i < n; i++) {
+        if (ds[i] == ' ') continue;
+        s[i] = (ds[i] == '&') ? ' ' : ds[i];
+    }
+    if (n2 > n1) {                  /*** characters appended to s ***/
+        for (; i < n2; i++) s[i] = (ds[i] == '&') ? ' ' : ds[i];
+        s[n2] = '\0';
+    }
+}
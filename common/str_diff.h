@@ -0,0 +1,23 @@
+/****************************************************************************/
+/*     str_diff.h : difference of the epoch lines and the flag strings      */
+/*                                                                          */
+/*     str_diff() puts the difference of s2 from s1 as in Compact RINEX:    */
+/*     ' ' for an unchanged character, '&' for a character changed to a    */
+/*     space, and the new character otherwise. str_repair() is the inverse. */
+/*     Both work on 16 bytes at a time with SSE2 or NEON when the compiler  */
+/*     targets them, and byte by byte otherwise. An unchanged string        */
+/*     (str_diff) or an empty difference (str_repair) is found first and    */
+/*     not scanned by character.                                            */
+/****************************************************************************/
+#ifndef STR_DIFF_H
+#define STR_DIFF_H
+
+/**** Put the difference of s2 from s1 to ds, chop the spaces at the end,  ****/
+/**** and add "\n". The spaces before ds are chopped, too, if the          ****/
+/**** difference is all spaces. Returns the pointer to the '\0' at the end. ****/
+char* str_diff(const char* s1, const char* s2, char* ds);
+
+/**** Apply the difference ds to s ('&' sets a space). ****/
+void  str_repair(char* s, const char* ds);
+
+#endif
@@ -0,0 +1,45 @@
+/****************************************************************************/
+/*     thread_pool.h : fixed-size pool of worker threads                    */
+/*                                                                          */
+/*     Used by RNX2CRX and CRX2RNX to convert many files in one process.    */
+/*     parallel_for() starts "nthread" workers which take the jobs          */
+/*     0 ... njob-1 in order from a shared counter, and returns when all    */
+/*     the jobs are finished. Each job must only touch its own data.        */
+/****************************************************************************/
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+/*---------------------------------------------------------------------*/
+inline int default_threads(void) {
+    /**** number of workers if not given by the user ****/
+    unsigned int n = std::thread::hardware_concurrency();
+    return (n > 0) ? (int)n : 1;
+}
+/*---------------------------------------------------------------------*/
+inline void parallel_for(size_t njob, int nthread, const std::function<void(size_t)>& job) {
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> workers;
+    size_t i;
+    int n;
+
+    if (nthread <= 0) nthread = default_threads();
+    if ((size_t)nthread > njob) nthread = (int)njob;
+    if (nthread <= 1) {                /**** no need to start threads ****/
+        for (i = 0; i < njob; i++) job(i);
+        return;
+    }
+    for (n = 0; n < nthread; n++) {
+        workers.emplace_back([&]() {
+            size_t k;
+            while ((k = next++) < njob) job(k);
+        });
+    }
+    for (n = 0; n < nthread; n++) workers[n].join();
+}
+
+#endif